@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "clock.h"
+#include "pet.h"
+#include "shop.h"
+
+enum PetAction : std::uint8_t {
+	ACTION_UPDATE = 1,      // The game advanced the pet to this time
+	ACTION_PLAY,
+	ACTION_SLEEP,
+	ACTION_CLEAN,
+	ACTION_USE_ITEM,        // argument: catalog ID of the item used
+	ACTION_BUY_ITEM,        // argument: shop item index
+	ACTION_NEW_PET,         // argument: 1 if the shop was reset too; name holds the pet name
+};
+
+struct ActionRecord {
+	std::time_t time;
+	PetAction action;
+	std::uint64_t argument;
+	std::string name;
+};
+
+// Append-only binary log of everything that changes a pet during a session.
+// Layout: "TAMALOG" + version byte, varint start time, varint starting money, then one
+// record per action: action byte, zigzag varint time delta, varint argument where needed.
+class ActionLogWriter {
+private:
+	std::ofstream outFile;
+	std::string buffer;
+	std::time_t lastTime;
+
+	void putVarint(std::uint64_t value);
+	void putHeader(std::time_t time, PetAction action);
+
+public:
+	ActionLogWriter();
+	~ActionLogWriter();
+
+	bool open(const std::string& filename, std::time_t startTime, int startMoney);
+	bool isOpen() const;
+	void record(std::time_t time, PetAction action, std::uint64_t argument = 0);
+	void recordNewPet(std::time_t time, const std::string& petName, bool shopReset);
+	void flush();
+};
+
+class ActionLogReader {
+private:
+	std::string data;
+	size_t position;
+	std::time_t lastTime;
+	std::time_t startTime;
+	int startMoney;
+
+	bool getVarint(std::uint64_t& value);
+
+public:
+	ActionLogReader();
+
+	bool open(const std::string& filename);
+	// False at the end of the log or on a truncated record
+	bool next(ActionRecord& record);
+
+	std::time_t getStartTime() const;
+	int getStartMoney() const;
+};
+
+struct ReplayStats {
+	size_t records;
+	size_t updates;
+	size_t actions;
+};
+
+// Rebuilds the pet and shop of a session: loads the start snapshot at the log's start time,
+// then re-applies every record with `clock` set to the time it happened at.
+bool replayActionLog(const std::string& snapshotFile, const std::string& logFile,
+	FixedStepClock& clock, std::unique_ptr<Pet>& pet, std::unique_ptr<PetShop>& shop, ReplayStats& stats);
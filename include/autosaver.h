@@ -0,0 +1,47 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "pet.h"
+#include "saveWorker.h"
+
+// Saves the pet only when it changed since the last save, and at most once per
+// interval so bursts of changes are coalesced into a single write. In background mode the
+// caller only takes a snapshot and a SaveWorker thread does the encoding and file I/O.
+class Autosaver {
+private:
+	using SteadyClock = std::chrono::steady_clock;
+
+	std::string filename;
+	double intervalSeconds;
+	SteadyClock::time_point lastSaveTime;
+	const Pet* savedPet;
+	std::uint64_t savedPetGeneration;
+	size_t saveCount;
+	bool statsLive;
+	std::unique_ptr<SaveWorker> worker;
+
+public:
+	Autosaver(const std::string& saveFile, double interval = 10.0, bool background = false);
+
+	void setInterval(double seconds);
+	double getInterval() const;
+	// When the stats persist themselves (LivePetState), only name and inventory changes count.
+	// Changing the mode drops the saved baseline, so the next flush writes.
+	void setStatsLive(bool live);
+
+	bool isDirty(const Pet& pet) const;
+	// Saves if dirty and the interval has passed since the last save; true if it wrote
+	bool maybeSave(const Pet& pet, SteadyClock::time_point now = SteadyClock::now());
+	// Seconds until maybeSave() would write; infinity while the pet is unchanged
+	double secondsUntilSave(const Pet& pet, SteadyClock::time_point now = SteadyClock::now()) const;
+	// Saves if dirty, ignoring the interval (e.g. on exit)
+	bool flush(const Pet& pet);
+	// Waits for background writes to reach disk and stops the worker thread
+	void finish();
+	// Treat the current state as already on disk (e.g. right after loading it)
+	void markSaved(const Pet& pet);
+
+	size_t getSaveCount() const;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "item.h"
+
+using ItemId = std::uint16_t;
+
+enum CatalogItem : ItemId {
+#define BALANCE_ITEM(id, name, type, price, effect, sideEffect) id,
+#include "balance.def"
+	ITEM_COUNT
+};
+
+struct CatalogEntry {
+	const char* name;
+	ItemType type;
+	int price;
+	int effect;
+	int sideEffect;
+};
+
+struct BalanceTable {
+#define BALANCE_VALUE(field, value) int field;
+#include "balance.def"
+	CatalogEntry items[ITEM_COUNT];
+};
+
+// The rules as written in balance.def, fixed at compile time
+constexpr BalanceTable DEFAULT_BALANCE = {
+#define BALANCE_VALUE(field, value) value,
+#include "balance.def"
+	{
+#define BALANCE_ITEM(id, name, type, price, effect, sideEffect) { name, type, price, effect, sideEffect },
+#include "balance.def"
+	}
+};
+
+// Stats are whole points in 0..MAX_STAT. Nonzero decay rates are whole points per minute, so
+// every stat has saturated after MAX_DECAY_MINUTES; fast-forwarding and the scalar and SIMD
+// population kernels all clamp their steps to it and must agree.
+constexpr int MAX_STAT = 100;
+constexpr int MAX_DECAY_MINUTES = MAX_STAT;
+
+static_assert(DEFAULT_BALANCE.hungerPerMinute > 0 && DEFAULT_BALANCE.ageIntervalMinutes > 0,
+	"hunger decay and aging must make progress");
+
+// Rules in effect: DEFAULT_BALANCE unless an override was loaded. Constant-initialized, so
+// reading it costs a load and never a first-use check.
+extern BalanceTable activeBalance;
+inline const BalanceTable& balance() { return activeBalance; }
+
+// Applies key=value lines over the defaults, e.g. "hungerPerMinute=4" or "Kibble.price=7"
+// (item keys: price, effect, sideEffect); '#' starts a comment. Load before any pet or shop
+// is created. Leaves the rules untouched and returns false on any bad line.
+bool loadBalanceOverride(const std::string& filename);
+
+// Puts `table` in effect for the lifetime of the object, then restores the rules it replaced
+// on every way out of the scope. Unvalidated, for tools that vary a rule on purpose; like
+// loadBalanceOverride, only while no pet or shop is in use on another thread.
+class ScopedBalance {
+private:
+	BalanceTable previous;
+
+public:
+	explicit ScopedBalance(const BalanceTable& table);
+	~ScopedBalance();
+	ScopedBalance(const ScopedBalance&) = delete;
+	ScopedBalance& operator=(const ScopedBalance&) = delete;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// When a simulated caretaker looks after the pet and what it does. Thresholds use the
+// same 0-100 stats as Pet; a threshold outside that range disables the action.
+struct CarePolicy {
+	int checkIntervalMinutes = 5;    // How often the caretaker looks at the pet
+	double attentiveness = 0.9;      // Chance that a check actually happens
+	int feedAtHunger = 60;           // Use a food item when hunger >= this
+	int medicineBelowHealth = 40;    // Use a medicine item when health < this
+	int sleepBelowEnergy = 30;
+	int cleanBelowCleanliness = 40;
+	int playBelowHappiness = 40;
+	std::string foodItem = "Kibble";         // Shop item bought when out of food
+	std::string medicineItem = "Pill";       // Shop item bought when out of medicine
+	int allowancePerDay = 5;         // Coins earned per day of pet age
+	int maxDays = 365;               // Simulation stops once the pet reaches this age
+};
+
+struct CareOutcome {
+	bool survived;      // Still alive at maxDays
+	int age;            // Age reached, in days
+	int coinsSpent;
+	int deathCause;     // DeathCause of the pet, DEATH_NONE if it survived
+};
+
+// Reads key=value lines (e.g. "feedAtHunger=70"); '#' starts a comment. Rejects an
+// attentiveness outside [0, 1] and item names that are not food/medicine in the catalog.
+bool loadCarePolicy(const std::string& filename, CarePolicy& policy);
+
+// Simulates one pet from birth under `policy`. Deterministic for a given seed. The pet is
+// given foodItem/medicineItem whenever it holds them, and other items of the type only when not.
+CareOutcome simulateCare(const CarePolicy& policy, std::uint64_t seed);
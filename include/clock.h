@@ -0,0 +1,46 @@
+#pragma once
+#include <chrono>
+#include <ctime>
+
+// Source of simulation time for pets and the game
+class Clock {
+public:
+	virtual ~Clock() = default;
+	virtual std::time_t now() const = 0;
+
+	// Shared real-time clock used when none is supplied
+	static const Clock& wall();
+};
+
+class WallClock : public Clock {
+public:
+	std::time_t now() const override;
+};
+
+// Only moves when advanced, by a fixed number of seconds per step
+class FixedStepClock : public Clock {
+private:
+	std::time_t current;
+	std::time_t stepSeconds;
+
+public:
+	FixedStepClock(std::time_t start, std::time_t step = 60);
+	std::time_t now() const override;
+
+	void advance();
+	void advanceTo(std::time_t time);
+	std::time_t getStep() const;
+};
+
+// Real time compressed by a constant factor, e.g. 10000x turns an hour into 0.36 seconds
+class AcceleratedClock : public Clock {
+private:
+	std::time_t start;
+	std::chrono::steady_clock::time_point realStart;
+	double factor;
+
+public:
+	AcceleratedClock(double speedFactor, std::time_t startTime = std::time(nullptr));
+	std::time_t now() const override;
+	double getFactor() const;
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "mappedFile.h"
+#include "petState.h"
+
+// Columnar population snapshots for offline analysis. Rows are written in row groups; inside
+// a group every PetState field is one contiguous column stored as plain little-endian values,
+// bit-packed offsets from the column minimum, or bit-packed deltas (for timestamps). The
+// writer streams one row group at a time; the reader maps the file and hands out views
+// straight into the mapping.
+//
+// Layout: "TAMACOL1" | row group* | footer: uint64 row group offsets[] | ColumnarTail
+// Row group: ColumnarGroupHeader | column data, each chunk 8-byte aligned
+
+enum PetColumn {
+	COLUMN_HUNGER,
+	COLUMN_HAPPINESS,
+	COLUMN_ENERGY,
+	COLUMN_CLEANLINESS,
+	COLUMN_HEALTH,
+	COLUMN_AGE,
+	COLUMN_IS_ALIVE,
+	COLUMN_IN_CRITICAL_HUNGER,
+	COLUMN_IN_CRITICAL_HEALTH,
+	COLUMN_LAST_UPDATE_TIME,
+	COLUMN_LAST_AGE_TIME,
+	COLUMN_BIRTH_TIME,
+	COLUMN_CRITICAL_HUNGER_START,
+	COLUMN_CRITICAL_HEALTH_START,
+	COLUMN_COUNT
+};
+
+enum ColumnEncoding : std::uint8_t { ENCODING_PLAIN, ENCODING_BITPACK, ENCODING_DELTA };
+
+struct ColumnChunk {
+	std::uint8_t encoding;
+	std::uint8_t bitWidth;       // plain: value width in bits (32 or 64)
+	std::uint16_t reserved;
+	std::uint32_t byteLength;
+	std::int64_t base;           // bitpack: column minimum; delta: first value
+	std::int64_t reference;      // delta: smallest delta
+	std::uint64_t offset;
+};
+
+struct ColumnarGroupHeader {
+	std::uint64_t rowCount;
+	ColumnChunk columns[COLUMN_COUNT];
+};
+
+struct ColumnarTail {
+	std::uint64_t rowGroupCount;
+	std::uint64_t rowCount;
+	std::uint64_t footerOffset;
+	char magic[8];
+};
+
+const char* columnName(PetColumn column);
+std::int64_t columnValue(const PetState& state, PetColumn column);
+
+class ColumnarWriter {
+private:
+	std::ofstream outFile;
+	std::uint64_t position;
+	size_t rowGroupSize;
+	bool allowPacking;
+	std::vector<std::int64_t> columns[COLUMN_COUNT];
+	std::vector<std::uint64_t> rowGroupOffsets;
+	std::uint64_t rowCount;
+
+	bool writeRowGroup();
+	bool writeBytes(const void* data, size_t size);
+
+public:
+	ColumnarWriter();
+	~ColumnarWriter();
+
+	// `packing` lets the writer pick bit-packed or delta chunks when they are smaller
+	bool open(const std::string& filename, size_t groupSize = 1 << 16, bool packing = true);
+	bool append(const PetState& state);
+	// Writes the last row group and the footer
+	bool close();
+
+	std::uint64_t getRowCount() const;
+};
+
+// View of one column chunk inside the mapped file; no data is copied
+class ColumnView {
+private:
+	const char* data;
+	size_t count;
+	ColumnChunk chunk;
+
+public:
+	ColumnView(const char* chunkData, size_t rowCount, const ColumnChunk& descriptor);
+
+	size_t size() const;
+	ColumnEncoding getEncoding() const;
+	int getBitWidth() const;
+	// Direct access for plain chunks (nullptr otherwise); values are little-endian
+	const std::int32_t* plain32() const;
+	const std::int64_t* plain64() const;
+
+	// Random access; O(index) for delta chunks, so prefer decode() for scans
+	std::int64_t get(size_t index) const;
+	// Unpacks the whole chunk into `out` (size() values)
+	void decode(std::int64_t* out) const;
+};
+
+class ColumnarReader {
+private:
+	MappedFile file;
+	std::vector<std::uint64_t> rowGroupOffsets;
+	std::uint64_t rowCount;
+
+public:
+	ColumnarReader();
+
+	bool open(const std::string& filename);
+	std::uint64_t getRowCount() const;
+	size_t getRowGroupCount() const;
+	size_t getRowGroupSize(size_t group) const;
+	ColumnView column(size_t group, PetColumn column) const;
+};
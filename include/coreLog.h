@@ -0,0 +1,11 @@
+#pragma once
+#include <ostream>
+
+// Console output of the simulation core. coreLog() is informational output (std::cout by
+// default), which batch tools running many pets switch off. coreError() carries every core
+// diagnostic, such as a damaged save or a bad config line (std::cerr by default); it has its
+// own switch so a tool can keep errors while silencing the chatter.
+std::ostream& coreLog();
+std::ostream& coreError();
+void setCoreLogging(bool enabled);
+void setCoreErrorLogging(bool enabled);
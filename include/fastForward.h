@@ -0,0 +1,33 @@
+#pragma once
+#include <ctime>
+#include "petState.h"
+#include "balance.h"
+
+enum DeathCause { DEATH_NONE, DEATH_STARVATION, DEATH_ILLNESS };
+
+enum PetEventKind { PET_EVENT_NONE, PET_EVENT_DECAY, PET_EVENT_CRITICAL, PET_EVENT_DEATH, PET_EVENT_AGING };
+
+// The next moment an update would change the pet; time is 0 when nothing will happen again
+struct PetEvent {
+	std::time_t time;
+	PetEventKind kind;
+};
+
+struct FastForwardResult {
+	PetState state;
+	std::time_t hungerCriticalTime;  // When hunger reached 80 during the step, 0 if it did not
+	std::time_t healthCriticalTime;  // When health fell to 20 during the step, 0 if it did not
+	std::time_t deathTime;           // 0 if the pet survived the step
+	DeathCause deathCause;
+	int daysAged;
+};
+
+// Advances a pet to `now` exactly as if it had been updated once at every whole minute since
+// lastUpdateTime and once more at `now`, in constant time regardless of how long it was away.
+FastForwardResult fastForward(const PetState& state, std::time_t now);
+
+// Reference implementation of the same step, ticking minute by minute
+FastForwardResult stepForward(const PetState& state, std::time_t now);
+
+// Predicts the next decay tick, critical-window entry, death or birthday of a pet
+PetEvent nextPetEvent(const PetState& state);
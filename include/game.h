@@ -4,14 +4,28 @@
 #include "textureManager.h"
 #include "pet.h"
 #include "shop.h"
+#include "clock.h"
+#include "petScheduler.h"
+#include "actionLog.h"
+#include "autosaver.h"
+#include "liveState.h"
+#include "quadBatch.h"
+#include "uiSources.h"
+
+// Screens whose draw calls are counted separately
+enum UiScreen { SCREEN_NAME_PROMPT, SCREEN_MAIN, SCREEN_INVENTORY, SCREEN_SHOP, SCREEN_SELECTION, SCREEN_DEATH, SCREEN_COUNT };
 
 class Game {
 private:
+	const Clock& clock;
 	sf::RenderWindow window;
 
 	TextureManager textureManager;
+	LivePetState liveState; // Declared before the pet, whose stats may live inside it
 	std::unique_ptr<Pet> pet;
 	std::unique_ptr<PetShop> shop;
+	std::unique_ptr<PetScheduler> scheduler;
+	size_t scheduledPetId;
 
 	sf::Texture backgroundTexture;
 	sf::Sprite backgroundSprite;
@@ -30,10 +44,34 @@ private:
 	std::unique_ptr<std::array<sf::RectangleShape, 7>> buttons;
 	std::unique_ptr<std::array<sf::Text, 7>> buttonLabels;
 	const std::string saveFilePath = "Saves/pet.save";
+	const std::string sessionSnapshotPath = "Saves/session.save";
+	const std::string actionLogPath = "Saves/session.log";
+	ActionLogWriter actionLog;
 	bool shouldSaveOnExit;
 
-	sf::Clock backgroundUpdateClock;
-	const float BACKGROUND_UPDATE_INTERVAL = 1.0f; // Update every second when not focused
+	const float AUTOSAVE_INTERVAL = 10.0f; // Seconds between autosaves, only written when something changed
+	Autosaver autosaver{ saveFilePath, AUTOSAVE_INTERVAL, true }; // Writes on a background thread
+
+	// Optional live stats file: the pet's stats are stored in a shared mapping and committed
+	// every LIVE_COMMIT_INTERVAL, so only name and inventory changes need a save
+	const std::string liveStatePath = "Saves/pet.live";
+	const float LIVE_COMMIT_INTERVAL = 1.0f;
+	sf::Clock liveCommitClock;
+	std::uint64_t liveCommittedGeneration;   // Pet generation of the last commit
+
+	// Frames are drawn only when something visible changed, at most FRAME_RATE_LIMIT per second.
+	// Otherwise the loop sleeps until the next pet event, restock, autosave or live commit,
+	// but never longer than IDLE_POLL_INTERVAL, since SFML can only poll for input.
+	const unsigned int FRAME_RATE_LIMIT = 60;
+	const float IDLE_POLL_INTERVAL = 0.05f;
+	std::uint64_t drawnSceneGeneration;
+
+	// While the window is unfocused nothing is drawn, the music is stopped (ending its
+	// streaming thread) and the loop sleeps until the next pet event or other scheduled
+	// work. BACKGROUND_MAX_SLEEP caps that so the focus coming back is noticed within it.
+	const float BACKGROUND_MAX_SLEEP = 1.0f;
+	bool inBackground;
+	sf::Time musicOffset;
 
 	// Death UI elements
 	sf::RectangleShape deathBox;
@@ -55,6 +93,7 @@ private:
 	bool showingInventory;
 	std::vector<sf::RectangleShape> inventoryItemBoxes;
 	std::vector<sf::Text> inventoryItemTexts;
+	std::vector<InventoryHandle> inventoryHandles;   // stack shown in each inventory box
 	sf::RectangleShape inventoryBackground;
 	sf::Text inventoryTitle;
 	sf::RectangleShape closeInventoryButton;
@@ -64,6 +103,7 @@ private:
 	bool showingShop;
 	std::vector<sf::RectangleShape> shopItemBoxes;
 	std::vector<sf::Text> shopItemTexts;
+	std::array<sf::Text, SHOP_ITEMS.size()> shopStockTexts;  // "N left" on each shelf's box
 	sf::RectangleShape shopBackground;
 	sf::Text shopTitle;
 	sf::RectangleShape closeShopButton;
@@ -71,27 +111,64 @@ private:
 
 	// Item selection UI elements
 	bool showingItemSelection;
-	std::string currentSelectionCategory;
+	ItemType currentSelectionType;
 	std::vector<sf::RectangleShape> selectionItemBoxes;
 	std::vector<sf::Text> selectionItemTexts;
+	std::vector<InventoryHandle> selectionHandles;   // stack shown in each selection box
 	sf::RectangleShape selectionBackground;
 	sf::Text selectionTitle;
 	sf::RectangleShape closeSelectionButton;
 	sf::Text closeSelectionText;
 
+	// What the retained widgets were built from. updateUI only touches widgets whose source
+	// changed, so a frame where nothing happened sets no strings and builds no shapes.
+	UiSources uiSources;
+
+	// Rectangles and hearts go out as one vertex array per layer and texture. The batches are
+	// rebuilt with their screen's layout; heart colours are updated in place.
+	QuadBatch heartBatch;            // Quad i * 5 + j is (*hearts)[i][j]
+	QuadBatch buttonBatch;
+	QuadBatch deathBatch;
+	QuadBatch namePromptBatch;
+	QuadBatch inventoryBatch;
+	QuadBatch shopBatch;
+	QuadBatch selectionBatch;
+
+	// Draw calls of the frame being drawn, and the last count printed for each screen
+	size_t frameDrawCalls;
+	std::array<size_t, SCREEN_COUNT> reportedDrawCalls;
+
 	void loadAssets();
 	void loadGameUI();
-	void createNewPet(const std::string& name);
+	void createNewPet(const std::string& name, bool resetShop = false);
+	void schedulePet();
+	void startActionLog();
+	void attachLiveState();
+	bool adoptLiveState();
 
-	void showItemsByCategory(const std::string& category);
-	void updateSelectionUI(const std::string& category);
+	void useInventoryItem(InventoryHandle handle);
+	void showItemsByType(ItemType type);
+	void updateSelectionUI(ItemType type);
 	void updateUI();
 	void updateInventoryUI();
 	void updateShopUI();
-	void handleEvents();
+	void refreshPetUI();
+	void refreshShopStock();
+	void setShelfStockText(size_t index);
+	// True if any event arrived
+	bool handleEvents();
+	std::uint64_t getSceneGeneration() const;
+	float secondsUntilWork(float cap) const;
+	void buildStaticBatches();
+	void draw(const sf::Drawable& drawable);
+	void draw(const QuadBatch& batch);
+	// Prints the screen's draw calls for this frame when they differ from the last report
+	void reportDrawCalls(UiScreen screen);
+	void enterBackground();
+	void leaveBackground();
 
 public:
-	Game();
+	Game(const Clock& simClock = Clock::wall(), bool useLiveState = false);
 	void run();
 };
 
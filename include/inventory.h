@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "itemCatalog.h"
+
+// How many of a catalog item the pet holds
+struct InventoryStack {
+	ItemId catalogId;
+	std::uint32_t count;
+};
+
+// Stable reference to a stack. A slot's generation changes when its stack is used up, so an
+// old handle is rejected rather than reaching whatever stack reuses the slot.
+struct InventoryHandle {
+	std::uint32_t slot;
+	std::uint32_t generation;
+
+	bool operator==(const InventoryHandle&) const = default;
+};
+
+// Slot map of stacks: dense storage for iteration, O(1) lookup by handle or catalog ID, and
+// O(1) removal (the last stack moves into the gap, handles stay valid)
+class Inventory {
+private:
+	struct Slot {
+		std::uint32_t dense;        // index into stacks while in use
+		std::uint32_t generation;
+		std::uint32_t typeIndex;    // index into handlesByType[type] while in use
+	};
+
+	static constexpr std::uint32_t NO_SLOT = UINT32_MAX;
+
+	std::vector<InventoryStack> stacks;
+	std::vector<std::uint32_t> denseToSlot;
+	std::vector<Slot> slots;
+	std::vector<std::uint32_t> freeSlots;
+	std::vector<std::uint32_t> slotByItem;     // indexed by ItemId
+	// Handles of each type's stacks. Unordered: a used-up stack's handle is replaced by the last.
+	std::array<std::vector<InventoryHandle>, ITEM_TYPE_COUNT> handlesByType;
+
+public:
+	// Adds to the item's stack, creating it if needed. False, and nothing added, for unknown
+	// IDs or if the stack would exceed UINT32_MAX items.
+	bool add(ItemId id, std::uint32_t count = 1);
+	// True if add(id, count) would succeed
+	bool canAdd(ItemId id, std::uint64_t count) const;
+	// Removes one item from the stack, and the stack itself once empty; false for stale handles
+	bool take(InventoryHandle handle);
+	// nullptr for stale handles
+	const InventoryStack* find(InventoryHandle handle) const;
+	// Handle of the item's stack; a handle that find() rejects if the pet has none
+	InventoryHandle findItem(ItemId id) const;
+	void clear();
+	void assign(std::span<const InventoryStack> saved);
+
+	// Dense, unordered view of every stack
+	std::span<const InventoryStack> getStacks() const;
+	InventoryHandle getHandle(size_t denseIndex) const;
+	std::span<const InventoryHandle> getHandlesByType(ItemType type) const;
+	size_t size() const;
+	bool empty() const;
+	std::uint32_t getItemCount() const;
+};
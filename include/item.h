@@ -1,41 +1,52 @@
 #pragma once
+#include <cstdint>
 #include <string>
 
 class Pet;
 
-class Item {
-protected:
-    std::string name;
-    int value;
-    bool consumed;
-
-public:
-    Item(const std::string& itemName, int itemValue);
-    virtual ~Item() = default;
+enum ItemType : std::uint8_t { ITEM_FOOD, ITEM_MEDICINE, ITEM_TYPE_COUNT };
 
-    virtual void use(Pet* pet) = 0;
+// "Food" or "Medicine", for labels
+const char* itemTypeName(ItemType type);
 
-    const std::string& getName() const;
-    int getValue() const;
-    bool isConsumed() const;
-};
-
-class FoodItem : public Item {
-private:
+struct FoodEffect {
     int hungerReduction;
     int energyBoost;
-
-public:
-    FoodItem(const std::string& foodName, int foodValue, int hungerReduc, int energyB);
-    void use(Pet* pet) override;
 };
 
-class MedicineItem : public Item {
-private:
+struct MedicineEffect {
     int healthBoost;
     int happinessReduction;
+};
+
+// Immutable item description; every instance lives in the ItemCatalog and is shared by all
+// pets and shops that hold it. A closed set of types tagged by `type`, so checking the kind
+// is a byte compare and `use` is an inline switch rather than RTTI and a virtual call.
+class Item {
+private:
+    std::string name;
+    int value;
+    ItemType type;
+    union {
+        FoodEffect food;            // ITEM_FOOD
+        MedicineEffect medicine;    // ITEM_MEDICINE
+    };
+
+    Item(const std::string& itemName, int itemValue, ItemType itemType);
 
 public:
-    MedicineItem(const std::string& medName, int medValue, int healthB, int happinessR);
-    void use(Pet* pet) override;
+    static Item makeFood(const std::string& foodName, int foodValue, int hungerReduc, int energyB);
+    static Item makeMedicine(const std::string& medName, int medValue, int healthB, int happinessR);
+
+    // Defined in pet.h, where Pet is complete, so callers can inline the switch
+    inline void use(Pet* pet) const;
+
+    const std::string& getName() const { return name; }
+    int getValue() const { return value; }
+    ItemType getType() const { return type; }
+    bool isFood() const { return type == ITEM_FOOD; }
+    bool isMedicine() const { return type == ITEM_MEDICINE; }
+    // Only valid for the matching type
+    const FoodEffect& getFoodEffect() const { return food; }
+    const MedicineEffect& getMedicineEffect() const { return medicine; }
 };
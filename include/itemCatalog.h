@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "item.h"
+#include "balance.h"
+
+// Interned table of every item described in balance.def: name, type, price and effects
+class ItemCatalog {
+private:
+	std::vector<Item> items;    // indexed by ItemId, in CatalogItem order
+	std::unordered_map<std::string, ItemId> idsByName;
+
+	ItemCatalog();
+	static ItemCatalog& instance();
+	void build(const BalanceTable& table);
+
+public:
+	static const ItemCatalog& get();
+	// Re-reads prices and effects after a balance override. IDs and names never change, and
+	// items are updated in place, so references into the catalog stay valid.
+	static void reloadBalance();
+
+	size_t size() const;
+	bool contains(ItemId id) const;
+	const Item& item(ItemId id) const;
+	bool find(const std::string& name, ItemId& id) const;
+};
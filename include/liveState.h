@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "mappedFile.h"
+#include "petState.h"
+
+// A pet's stat block kept directly in a shared memory-mapped file. Stores to the live block
+// reach the page cache with no save step. commit() copies it into the older of two
+// checksummed slots with a higher sequence number and schedules a flush. After a crash,
+// recover() returns the newest slot that still checksums, so at most one commit interval
+// is lost. The file holds a raw PetState and is only meant to be read by the same build.
+class LivePetState {
+private:
+	struct Slot {
+		std::uint64_t sequence;
+		std::uint64_t checksum;
+		PetState state;
+	};
+
+	struct Layout {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t stateSize;
+		PetState live;
+		Slot slots[2];
+	};
+
+	MappedFile file;
+	Layout* layout;
+	bool readOnly;
+
+	static std::uint64_t slotChecksum(const Slot& slot);
+	const Slot* newestSlot() const;
+
+public:
+	LivePetState();
+	~LivePetState();
+
+	// Maps the file, creating or reinitialising it if it is missing or from another build
+	bool open(const std::string& filename);
+	// Maps an existing file only to recover() from it: nothing is written, committed or
+	// reinitialised, and false if the file is missing or from another build
+	bool openReadOnly(const std::string& filename);
+	void close();
+	bool isOpen() const;
+
+	// Last committed state, if any slot is intact
+	bool recover(PetState& state) const;
+	// The live block; point a Pet at it with Pet::attachState(). Null when read-only.
+	PetState* getState();
+	// Snapshot the live block into a slot and flush; `wait` blocks until it is on disk.
+	// close() commits too, unless the file was opened read-only.
+	bool commit(bool wait = false);
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Memory mapping of a whole file (mmap on POSIX, file mapping on Windows). Read-only by
+// default; openWritable() maps it shared so stores go straight to the page cache.
+class MappedFile {
+private:
+	char* data;
+	size_t length;
+	bool writable;
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+
+public:
+	MappedFile();
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& filename);
+	// Creates the file if needed and resizes it to `size` bytes (new bytes are zero)
+	bool openWritable(const std::string& filename, size_t size);
+	void close();
+	// Writes dirty pages back to the file; without `wait` the flush is only scheduled
+	bool sync(bool wait);
+
+	const char* getData() const;
+	char* getWritableData();
+	size_t getSize() const;
+};
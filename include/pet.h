@@ -1,40 +1,55 @@
 #pragma once
 #include <string>
 #include <ctime>
+#include <cstdint>
 #include <vector>
 #include <memory>
-#include "Item.h"
+#include "inventory.h"
+#include "petState.h"
+#include "fastForward.h"
+#include "clock.h"
+#include "saveFormat.h"
+#include "coreLog.h"
 
 enum PetMood { NORMAL, HAPPY, SAD, HUNGRY, TIRED, DIRTY, DEAD };
 
 class Pet {
 private:
-	int hunger;         // 0-100 (0: full, 100: starving)
-	int happiness;      // 0-100 (0: sad, 100: very happy)
-	int energy;         // 0-100 (0: exhausted, 100: energetic)
-	int cleanliness;    // 0-100 (0: dirty, 100: clean)
-	int health;         // 0-100 (0: sick, 100: healthy)
-	int age;            // in days
-	bool isAlive;
+	PetState ownState;
+	PetState* state;            // ownState, or an external block such as a live mapped file
 	std::string name;
-	std::time_t lastUpdateTime;
-	std::time_t lastAgeTime;       // Last time the pet aged
-	std::time_t birthTime;
-	std::time_t criticalHungerStartTime; // When hunger >=80
-	std::time_t criticalHealthStartTime; // When health <=20
-	bool isInCriticalHunger;
-	bool isInCriticalHealth;
+	const Clock* clock;
+	std::uint64_t generation;   // bumped on every change that a save would record
+	std::uint64_t inventoryGeneration;   // bumped when the name or inventory change
 
-	std::vector<std::unique_ptr<Item>> inventory;
+	Inventory inventory;    // one stack per catalog item held
+
+	void catchUp(std::time_t currentTime, bool whileAway);
+	bool readBinarySave(const char* data, size_t size);
+	bool readTextSave(const std::string& filename);
+	// Maps an item saved by name (legacy saves) onto the catalog
+	void addSavedItem(const std::string& itemName, std::uint32_t count);
 
 public:
-	Pet(const std::string& petName);
+	Pet(const std::string& petName, const Clock& simClock = Clock::wall());
 	~Pet();
+	Pet(const Pet&) = delete;
+	Pet& operator=(const Pet&) = delete;
 
 	bool savePetToFile(const std::string& filename) const;
+	bool savePetToTextFile(const std::string& filename) const;
+	// Copy of the stats, timestamps and inventory for saving off the main thread
+	PetSnapshot snapshot() const;
+	// Replaces the pet with a saved copy (e.g. from a PetStore) and catches it up to now
+	void restore(const PetSnapshot& snapshot);
+	// Reads binary saves and migrates legacy text saves
 	bool loadPetFromFile(const std::string& filename);
 
 	void update();
+	void update(std::time_t currentTime);
+	// Bring stats, critical timers and age up to `currentTime` in constant time
+	FastForwardResult advanceTo(std::time_t currentTime);
+	PetEvent nextEvent() const;
 	void feed(int amount);
 	void play();
 	void sleep();
@@ -42,9 +57,11 @@ public:
 	void medicine(int amount);
 
 	// Inventory management
-	void addItemToInventory(Item* newItem);
-	bool useItemFromInventory(size_t index);
-	const std::vector<std::unique_ptr<Item>>& getInventory() const;
+	// False, and nothing added, for unknown items or a stack that would overflow
+	bool addItemToInventory(ItemId id, std::uint32_t count = 1);
+	// Uses one item from the stack; false if the handle is stale
+	bool useItemFromInventory(InventoryHandle handle);
+	const Inventory& getInventory() const;
 
 	// Getters
 	int getHunger() const;
@@ -56,4 +73,29 @@ public:
 	bool getIsAlive() const;
 	std::string getName() const;
 	std::string getMood() const;
-};
\ No newline at end of file
+	const PetState& getState() const;
+	void setState(const PetState& newState);
+	std::uint64_t getGeneration() const;
+	std::uint64_t getInventoryGeneration() const;
+
+	// Keep the stats in `external` from now on (current values are copied there first);
+	// nullptr moves them back into the pet. The block must outlive the pet or be detached.
+	void attachState(PetState* external);
+};
+
+inline void Item::use(Pet* pet) const {
+	if (!pet) return;
+
+	switch (type) {
+	case ITEM_FOOD:
+		pet->feed(food.hungerReduction);
+		coreLog() << "Fed " << name << " to pet. Hunger reduced by " << food.hungerReduction << std::endl;
+		break;
+	case ITEM_MEDICINE:
+		pet->medicine(medicine.healthBoost);
+		coreLog() << "Used " << name << " on pet. Health increased by " << medicine.healthBoost << std::endl;
+		break;
+	default:
+		break;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "pet.h"
+#include "threadPool.h"
+
+enum DecayKernel { DECAY_SCALAR, DECAY_SSE41, DECAY_AVX2 };
+
+// Structure-of-arrays storage for large pet populations: every stat lives in its own
+// contiguous array so the per-minute decay can run as a vectorised kernel.
+class PetPopulation {
+private:
+	std::vector<std::int32_t> hunger;
+	std::vector<std::int32_t> happiness;
+	std::vector<std::int32_t> energy;
+	std::vector<std::int32_t> cleanliness;
+	std::vector<std::int32_t> health;
+	std::vector<std::uint8_t> alive;   // 1: alive, 0: dead (dead pets are not decayed)
+
+public:
+	void reserve(size_t count);
+	size_t size() const;
+
+	size_t addPet(const Pet& pet);
+	size_t addPet(int petHunger, int petHappiness, int petEnergy, int petCleanliness, int petHealth, bool isAlive = true);
+
+	// Apply `minutes` whole minutes of decay, clamping and health derivation to every living pet
+	void decay(int minutes);
+	void decay(int minutes, DecayKernel kernel);
+	void decayRange(size_t begin, size_t end, int minutes, DecayKernel kernel);
+
+	// Sharded decay across a thread pool. Shards are fixed contiguous ranges, so results do
+	// not depend on the number of threads and no locking is needed on the pets themselves.
+	static constexpr size_t SHARD_SIZE = 1 << 16;
+	size_t getShardCount() const;
+	void decay(int minutes, ThreadPool& pool);
+	// `ticks` steps of `minutes` each, with every shard running all of its steps while it is
+	// still in cache. Same result as calling decay(minutes, pool) `ticks` times, but one pass
+	// over memory instead of `ticks`, which is what bounds the per-tick version.
+	void decayTicks(int ticks, int minutes, ThreadPool& pool);
+
+	// Fastest kernel supported by the running CPU
+	static DecayKernel bestKernel();
+	static const char* kernelName(DecayKernel kernel);
+
+	int getHunger(size_t index) const;
+	int getHappiness(size_t index) const;
+	int getEnergy(size_t index) const;
+	int getCleanliness(size_t index) const;
+	int getHealth(size_t index) const;
+	bool getIsAlive(size_t index) const;
+	void setIsAlive(size_t index, bool isAlive);
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include "pet.h"
+#include "timerWheel.h"
+
+// Event-driven replacement for calling Pet::update() on every pet every frame: each pet
+// sits in a timer wheel at its next predicted event and is only updated when it fires.
+class PetScheduler {
+private:
+	TimerWheel wheel;
+	std::vector<Pet*> pets;
+	std::vector<std::uint32_t> generations; // Timers carrying an older generation are stale
+	std::vector<size_t> freeIds;
+	std::vector<TimerEntry> expired;
+	std::array<size_t, PET_EVENT_AGING + 1> eventCounts;
+
+	void schedule(size_t id, std::time_t now);
+
+public:
+	explicit PetScheduler(std::time_t start);
+
+	size_t addPet(Pet* pet);
+	void removePet(size_t id);
+	// Call after anything outside the scheduler changed the pet (feeding, playing, loading)
+	void reschedule(size_t id);
+
+	// Updates every pet with an event due by `now`; returns how many pets were updated
+	size_t advanceTo(std::time_t now);
+
+	// When advanceTo() may next have work; see TimerWheel::nextExpiry()
+	std::time_t nextDueTime() const;
+
+	size_t getEventCount(PetEventKind kind) const;
+	size_t getScheduledCount() const;
+};
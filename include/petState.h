@@ -0,0 +1,22 @@
+#pragma once
+#include <ctime>
+
+// Everything about a pet except its name and inventory
+struct PetState {
+	int hunger;         // 0-100 (0: full, 100: starving)
+	int happiness;      // 0-100 (0: sad, 100: very happy)
+	int energy;         // 0-100 (0: exhausted, 100: energetic)
+	int cleanliness;    // 0-100 (0: dirty, 100: clean)
+	int health;         // 0-100 (0: sick, 100: healthy)
+	int age;            // in days
+	bool isAlive;
+	std::time_t lastUpdateTime;
+	std::time_t lastAgeTime;       // Last time the pet aged
+	std::time_t birthTime;
+	std::time_t criticalHungerStartTime; // When hunger >=80
+	std::time_t criticalHealthStartTime; // When health <=20
+	bool isInCriticalHunger;
+	bool isInCriticalHealth;
+
+	bool operator==(const PetState&) const = default;
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "saveFormat.h"
+
+// Many pets in one file, keyed by name. Layout (little-endian, offsets from file start):
+//   StoreHeader | bucket array | records and heap blocks, allocated from the end of the file
+// Each pet has a fixed-size StoreRecord (stats plus bookkeeping) and one heap block holding
+// its name and inventory. Lookups hash the name to a bucket and follow the chain, comparing
+// stored hashes first, so finding a pet touches only a few small reads. Stats are updated in
+// place; removed records and heap blocks go on free lists and are reused before the file grows.
+
+struct StoreHeader {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t reserved;
+	std::uint64_t petCount;
+	std::uint64_t bucketOffset;
+	std::uint64_t bucketCount;           // power of two
+	std::uint64_t fileEnd;               // next allocation goes here
+	std::uint64_t freeRecords;           // head of the free record list, 0 if empty
+	std::uint64_t freeBlocks[32];        // free heap blocks by size class (32 << class bytes)
+};
+
+struct StoreRecord {
+	std::uint64_t nameHash;
+	std::uint64_t next;                  // next record in the bucket chain or the free list
+	std::uint64_t heapOffset;
+	std::uint32_t heapLength;
+	std::uint32_t heapClass;
+	std::uint32_t nameLength;
+	std::uint32_t reserved0;
+	std::int64_t lastUpdateTime;
+	std::int64_t lastAgeTime;
+	std::int64_t birthTime;
+	std::int64_t criticalHungerStartTime;
+	std::int64_t criticalHealthStartTime;
+	std::int32_t hunger;
+	std::int32_t happiness;
+	std::int32_t energy;
+	std::int32_t cleanliness;
+	std::int32_t health;
+	std::int32_t age;
+	std::uint8_t isAlive;
+	std::uint8_t isInCriticalHunger;
+	std::uint8_t isInCriticalHealth;
+	std::uint8_t reserved1;
+	std::uint32_t reserved2;
+};
+
+static_assert(sizeof(StoreHeader) == 312, "StoreHeader layout changed");
+static_assert(sizeof(StoreRecord) == 112, "StoreRecord layout changed");
+
+class PetStore {
+private:
+	std::fstream file;
+	StoreHeader header;
+	std::string path;
+
+	bool readAt(std::uint64_t offset, void* data, size_t size);
+	bool writeAt(std::uint64_t offset, const void* data, size_t size);
+	bool readRecord(std::uint64_t offset, StoreRecord& record);
+	bool writeRecord(std::uint64_t offset, const StoreRecord& record);
+	bool writeHeader();
+
+	// Finds the record for `name`; `previous` is the chain link pointing at it (0 for the bucket)
+	bool findRecord(const std::string& name, std::uint64_t& offset, StoreRecord& record, std::uint64_t* previous = nullptr);
+	bool readName(const StoreRecord& record, std::string& name);
+
+	std::uint64_t allocateRecord();
+	std::uint64_t allocateBlock(std::uint32_t sizeClass);
+	void freeBlock(std::uint64_t offset, std::uint32_t sizeClass);
+	std::uint64_t bucketSlot(std::uint64_t hash) const;
+	bool growBuckets();
+
+public:
+	PetStore();
+	~PetStore();
+	PetStore(const PetStore&) = delete;
+	PetStore& operator=(const PetStore&) = delete;
+
+	// Opens an existing store, or creates one sized for roughly `expectedPets`
+	bool open(const std::string& filename, size_t expectedPets = 1024);
+	void close();
+	bool isOpen() const;
+
+	size_t size() const;
+	bool contains(const std::string& name);
+
+	// Inserts or replaces the whole pet, inventory included
+	bool put(const PetSnapshot& snapshot);
+	bool load(const std::string& name, PetSnapshot& snapshot);
+	// Stats only: one record read, no heap access
+	bool loadState(const std::string& name, PetState& state);
+	// Rewrites the fixed-size stat record in place
+	bool updateState(const std::string& name, const PetState& state);
+	bool remove(const std::string& name);
+
+	// Every stored name, in bucket order
+	std::vector<std::string> names();
+};
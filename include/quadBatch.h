@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <SFML/Graphics.hpp>
+
+// Quads sharing one texture (or none), kept in a single vertex array so the whole batch is
+// one draw call. Add quads only when the layout changes; colours can be updated in place.
+class QuadBatch {
+private:
+	static constexpr size_t VERTICES_PER_QUAD = 6;
+
+	sf::VertexArray vertices;
+	const sf::Texture* texture;
+
+	void addQuad(const sf::Transform& transform, const sf::FloatRect& rect, const sf::FloatRect& texRect, sf::Color color);
+
+public:
+	QuadBatch();
+
+	// Removes every quad; textured batches only accept sprites using `batchTexture`
+	void clear(const sf::Texture* batchTexture = nullptr);
+
+	// One quad with the sprite's transform, texture rectangle and colour
+	size_t addSprite(const sf::Sprite& sprite);
+	// The fill, then the outline as four quads. Untextured batches only.
+	void addRectangle(const sf::RectangleShape& shape);
+
+	void setQuadColor(size_t quad, sf::Color color);
+	void draw(sf::RenderTarget& target) const;
+	size_t getQuadCount() const;
+};
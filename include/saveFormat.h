@@ -0,0 +1,114 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "petState.h"
+#include "inventory.h"
+
+// Binary save layout (version 2), little-endian, 8-byte aligned records:
+//   SaveHeader | SavePetRecord | SaveItemRecord[inventoryCount] | name bytes
+// Version 1 stored one SaveItemRecordV1 per item with its name; those saves are migrated by
+// looking the names up in the ItemCatalog.
+// All offsets are from the start of the file. Loading validates the bounds once and then
+// reads the records in place from the mapped file.
+
+constexpr char SAVE_MAGIC[8] = { 'T', 'A', 'M', 'A', 'S', 'A', 'V', 'E' };
+constexpr std::uint32_t SAVE_VERSION = 2;
+
+enum SaveItemType : std::uint8_t { SAVE_ITEM_FOOD = 1, SAVE_ITEM_MEDICINE = 2 };
+
+struct SaveHeader {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t fileSize;
+	std::uint32_t checksum;    // FNV-1a of every byte after the header
+	std::uint32_t reserved;
+};
+
+struct SavePetRecord {
+	std::int64_t lastUpdateTime;
+	std::int64_t lastAgeTime;
+	std::int64_t birthTime;
+	std::int64_t criticalHungerStartTime;
+	std::int64_t criticalHealthStartTime;
+	std::int32_t hunger;
+	std::int32_t happiness;
+	std::int32_t energy;
+	std::int32_t cleanliness;
+	std::int32_t health;
+	std::int32_t age;
+	std::uint8_t isAlive;
+	std::uint8_t isInCriticalHunger;
+	std::uint8_t isInCriticalHealth;
+	std::uint8_t reserved0;
+	std::uint32_t nameOffset;
+	std::uint32_t nameLength;
+	std::uint32_t inventoryOffset;
+	std::uint32_t inventoryCount;
+	std::uint32_t reserved1;
+};
+
+// One inventory stack
+struct SaveItemRecord {
+	std::uint16_t catalogId;
+	std::uint16_t reserved;
+	std::uint32_t count;
+};
+
+struct SaveItemRecordV1 {
+	std::int32_t value;
+	std::uint8_t type;
+	std::uint8_t consumed;
+	std::uint16_t nameLength;
+	std::uint32_t nameOffset;
+	std::uint32_t reserved;
+};
+
+static_assert(sizeof(SaveHeader) == 24, "SaveHeader layout changed");
+static_assert(sizeof(SavePetRecord) == 88, "SavePetRecord layout changed");
+static_assert(sizeof(SaveItemRecord) == 8, "SaveItemRecord layout changed");
+static_assert(sizeof(SaveItemRecordV1) == 16, "SaveItemRecordV1 layout changed");
+
+// Identity on little-endian hosts, byte swap elsewhere; use on every field read or written
+template <typename T>
+T littleEndian(T value) {
+	if constexpr (std::endian::native == std::endian::little || sizeof(T) == 1) {
+		return value;
+	}
+	else {
+		unsigned char bytes[sizeof(T)];
+		std::memcpy(bytes, &value, sizeof(T));
+		for (size_t i = 0; i < sizeof(T) / 2; i++) {
+			unsigned char swap = bytes[i];
+			bytes[i] = bytes[sizeof(T) - 1 - i];
+			bytes[sizeof(T) - 1 - i] = swap;
+		}
+		std::memcpy(&value, bytes, sizeof(T));
+		return value;
+	}
+}
+
+// Self-contained copy of everything a save records, safe to hand to another thread
+struct PetSnapshot {
+	PetState state;
+	std::string name;
+	std::vector<InventoryStack> inventory;
+};
+
+std::uint32_t saveChecksum(const char* data, size_t size);
+
+bool createSaveDirectory(const std::string& filename);
+void encodePetSave(const PetSnapshot& snapshot, std::string& buffer);
+// Encodes the snapshot and replaces `filename` atomically (temp file + rename)
+bool writePetSave(const PetSnapshot& snapshot, const std::string& filename);
+
+// True if the buffer starts with the binary save magic (otherwise it may be a legacy text save)
+bool isBinarySave(const char* data, size_t size);
+
+// Checks magic, version, size, checksum and every offset, then returns a view of the pet
+// record inside `data`, or nullptr if the save is damaged. `version` receives the file version
+// (1 or 2), which decides whether the inventory holds SaveItemRecordV1 or SaveItemRecord.
+const SavePetRecord* viewPetSave(const char* data, size_t size, std::uint32_t* version = nullptr);
@@ -0,0 +1,48 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "saveFormat.h"
+
+// Background thread that writes pet snapshots to one save file. Double buffered: submit()
+// swaps the caller's snapshot into the pending slot and returns; the worker swaps it out and
+// encodes and writes it without holding the lock. A newer snapshot replaces a pending one
+// that has not been picked up yet, since only the latest state matters.
+class SaveWorker {
+private:
+	std::string filename;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable idle;
+	PetSnapshot pending;
+	bool hasPending;
+	bool writing;
+	bool stopping;
+	size_t writtenCount;
+	size_t replacedCount;
+	size_t failedCount;
+
+	std::thread thread;
+
+	void workerLoop();
+
+public:
+	explicit SaveWorker(const std::string& saveFile);
+	~SaveWorker();
+	SaveWorker(const SaveWorker&) = delete;
+	SaveWorker& operator=(const SaveWorker&) = delete;
+
+	// Hands over the snapshot (its contents are swapped out); never waits for disk I/O
+	void submit(PetSnapshot& snapshot);
+	// Blocks until every submitted snapshot has been written
+	void flush();
+	// Flushes and joins the thread; later submits are written synchronously
+	void stop();
+
+	size_t getWrittenCount();
+	size_t getReplacedCount();
+	size_t getFailedCount();
+};
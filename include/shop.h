@@ -1,25 +1,66 @@
 #pragma once
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <span>
 #include <vector>
 #include <memory>
 #include <iostream>
-#include "Pet.h"
+#include "pet.h"
 
+// One line of a batch purchase: `quantity` of the shop item at `index`
+struct PurchaseOrder {
+	size_t index;
+	std::uint32_t quantity;
+};
+
+// One shelf per item, in display order
+constexpr std::array<ItemId, 6> SHOP_ITEMS = {
+	ITEM_KIBBLE, ITEM_CANNED_FOOD, ITEM_TREAT,
+	ITEM_PILL, ITEM_INJECTION, ITEM_GOLDEN_PILL
+};
+
+// Each shelf holds up to balance().shopStockPerItem units. The first sale from a full shop
+// schedules a restock shopRestockMinutes after the sale time, which refills only the shelves
+// that sold something. Callers pass the time of each sale, so a replayed action log sees the
+// same restocks as the session that wrote it.
 class PetShop {
 private:
-	std::vector<std::unique_ptr<Item>> shopItems;
+	static_assert(SHOP_ITEMS.size() <= 32, "depletedShelves has one bit per shelf");
+
+	std::array<std::uint32_t, SHOP_ITEMS.size()> stock;
+	// Bumped when a shelf's stock changes, so the UI can redraw just that row
+	std::array<std::uint64_t, SHOP_ITEMS.size()> shelfGenerations;
+	std::uint32_t depletedShelves;     // Bit per shelf below full stock
+	std::time_t restockTime;           // When the depleted shelves refill
 	int playerMoney;
+	std::uint64_t generation;
+
+	void takeStock(size_t index, std::uint32_t quantity, std::time_t now);
 
 public:
 	PetShop();
 
 	~PetShop();
 
+	// Refills the depleted shelves now
 	void restockShop();
+	// Runs a restock that has come due by `now`; buying does this itself
+	void advanceTo(std::time_t now);
 
-	bool buyItem(size_t index, Pet* pet);
+	bool buyItem(size_t index, Pet* pet, std::time_t now);
+	// All or nothing: checks every index, the stock and the total cost first, then debits the
+	// money once and adds each item as one stack. False (and nothing changes) if any order is
+	// invalid or the player cannot afford the whole batch.
+	bool buyItems(std::span<const PurchaseOrder> orders, Pet* pet, std::time_t now);
 
 	int getMoney() const;
 	void addMoney(int amount);
 
-	const std::vector<std::unique_ptr<Item>>& getShopItems() const;
-};
\ No newline at end of file
+	std::span<const ItemId> getShopItems() const;
+	std::uint32_t getStock(size_t index) const;
+	// When the pending restock comes due; max time_t if no shelf is depleted
+	std::time_t getRestockTime() const;
+	std::uint64_t getShelfGeneration(size_t index) const;
+	std::uint64_t getGeneration() const;
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads with one task deque each. parallelFor() gives each worker a
+// contiguous block of task indices; a worker drains its own deque from the front and, once
+// empty, steals from the back of the others. The call returns only after every task has run (a barrier).
+class ThreadPool {
+private:
+	struct WorkerQueue {
+		std::mutex mutex;
+		std::deque<size_t> tasks;
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::vector<std::thread> workers;
+
+	std::mutex jobMutex;
+	std::condition_variable jobReady;
+	std::condition_variable jobDone;
+	const std::function<void(size_t)>* job;
+	size_t jobGeneration;
+	size_t pendingTasks;
+	size_t busyWorkers;
+	bool stopping;
+
+	std::atomic<size_t> stolenTasks;
+
+	bool popTask(size_t worker, size_t& task);
+	void runTasks(size_t worker, const std::function<void(size_t)>& fn);
+	void workerLoop(size_t worker);
+
+public:
+	// threadCount 0 uses every hardware thread; the calling thread always takes part as worker 0
+	explicit ThreadPool(size_t threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Runs fn(0) .. fn(taskCount - 1) across the pool and waits for all of them
+	void parallelFor(size_t taskCount, const std::function<void(size_t)>& fn);
+
+	size_t getThreadCount() const;
+	size_t getStolenTaskCount() const;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+struct TimerEntry {
+	std::time_t expiry;
+	std::uint64_t id;
+};
+
+// Hierarchical timing wheel with one-second resolution: four levels of 64 slots cover
+// about 194 days, later timers wait in an overflow list. Scheduling is O(1) and each
+// timer is cascaded at most once per level before it fires.
+class TimerWheel {
+private:
+	static constexpr int LEVELS = 4;
+	static constexpr int SLOT_BITS = 6;
+	static constexpr int SLOTS = 1 << SLOT_BITS;
+	static constexpr std::time_t SLOT_MASK = SLOTS - 1;
+
+	std::array<std::array<std::vector<TimerEntry>, SLOTS>, LEVELS> wheels;
+	std::vector<TimerEntry> overflow;
+	std::time_t current;    // Next second to process; everything before it has fired
+	size_t timerCount;
+
+	void place(const TimerEntry& entry);
+	void cascade(int level);
+
+public:
+	explicit TimerWheel(std::time_t start);
+
+	void schedule(std::time_t expiry, std::uint64_t id);
+
+	// Appends every timer with expiry <= now to `expired`, in expiry order
+	void advance(std::time_t now, std::vector<TimerEntry>& expired);
+
+	// Earliest second a timer can fire: exact when one is due before the next level boundary,
+	// otherwise that boundary, where the next block cascades down. Never later than the real
+	// next expiry, so a caller sleeping until then is at worst woken early. Stale timers the
+	// owner will skip still count. Max time_t when no timer is scheduled.
+	std::time_t nextExpiry() const;
+
+	size_t size() const;
+	std::time_t getCurrentTime() const;
+};
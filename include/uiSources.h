@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "pet.h"
+#include "shop.h"
+
+// Which of the retained widgets a frame has to rebuild
+struct UiRefresh {
+	bool pet;
+	bool inventory;
+	bool shop;
+};
+
+// What the game's retained widgets were last built from. Each screen is keyed on the object
+// it shows as well as that object's generation: a new pet or shop counts from zero again,
+// so a generation alone could match widgets built for the previous one. Kept free of SFML
+// so the steady-state frame checks in TamaTamaBench can use it headless.
+class UiSources {
+private:
+	const Pet* pet;
+	std::uint64_t petGeneration;
+	const Pet* inventoryPet;
+	std::uint64_t inventoryGeneration;
+	const PetShop* shop;
+	std::uint64_t shopGeneration;
+	std::array<std::uint64_t, SHOP_ITEMS.size()> shelfGenerations;
+	size_t rebuildCount;
+
+public:
+	UiSources();
+
+	bool petChanged(const Pet& current) const;
+	bool inventoryChanged(const Pet& current) const;
+	bool shopChanged(const PetShop& current) const;
+	// Only meaningful for the shop the shop widgets were built from
+	bool shelfChanged(const PetShop& current, size_t index) const;
+	// The decision Game::updateUI acts on: the pet widgets whenever their source moved, the
+	// inventory and shop only while their screen is open and the pet is alive
+	UiRefresh plan(const Pet& currentPet, const PetShop& currentShop, bool inventoryShown, bool shopShown) const;
+
+	// Record that the widgets were rebuilt from `current`
+	void markPet(const Pet& current);
+	void markInventory(const Pet& current);
+	void markShop(const PetShop& current);
+	void markShelf(const PetShop& current, size_t index);
+	// Forget the shop sources, e.g. after the shop layout itself was rebuilt
+	void invalidateShop();
+
+	// Number of mark calls; a frame in which nothing changed must not move it
+	size_t getRebuildCount() const;
+};
@@ -0,0 +1,217 @@
+#include <iostream>
+#include <iterator>
+#include "actionLog.h"
+#include "coreLog.h"
+
+namespace {
+
+const char LOG_MAGIC[7] = { 'T', 'A', 'M', 'A', 'L', 'O', 'G' };
+constexpr std::uint8_t LOG_VERSION = 1;
+constexpr size_t FLUSH_THRESHOLD = 4096;
+
+std::uint64_t zigzag(std::int64_t value) {
+	return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+	return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+}
+
+ActionLogWriter::ActionLogWriter() : lastTime(0) {}
+
+ActionLogWriter::~ActionLogWriter() {
+	flush();
+}
+
+bool ActionLogWriter::open(const std::string& filename, std::time_t startTime, int startMoney) {
+	flush();
+	outFile.close();
+	outFile.open(filename, std::ios::binary | std::ios::trunc);
+	if (!outFile.is_open()) {
+		coreError() << "Failed to open action log for writing" << std::endl;
+		return false;
+	}
+
+	buffer.assign(LOG_MAGIC, sizeof(LOG_MAGIC));
+	buffer.push_back(static_cast<char>(LOG_VERSION));
+	putVarint(static_cast<std::uint64_t>(startTime));
+	putVarint(zigzag(startMoney));
+	lastTime = startTime;
+	flush();
+	return true;
+}
+
+bool ActionLogWriter::isOpen() const {
+	return outFile.is_open();
+}
+
+void ActionLogWriter::putVarint(std::uint64_t value) {
+	while (value >= 0x80) {
+		buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back(static_cast<char>(value));
+}
+
+void ActionLogWriter::putHeader(std::time_t time, PetAction action) {
+	buffer.push_back(static_cast<char>(action));
+	putVarint(zigzag(static_cast<std::int64_t>(time - lastTime)));
+	lastTime = time;
+}
+
+void ActionLogWriter::record(std::time_t time, PetAction action, std::uint64_t argument) {
+	if (!outFile.is_open()) return;
+
+	putHeader(time, action);
+	if (action == ACTION_USE_ITEM || action == ACTION_BUY_ITEM) {
+		putVarint(argument);
+	}
+	if (buffer.size() >= FLUSH_THRESHOLD) flush();
+}
+
+void ActionLogWriter::recordNewPet(std::time_t time, const std::string& petName, bool shopReset) {
+	if (!outFile.is_open()) return;
+
+	putHeader(time, ACTION_NEW_PET);
+	putVarint(shopReset ? 1 : 0);
+	putVarint(petName.size());
+	buffer += petName;
+	if (buffer.size() >= FLUSH_THRESHOLD) flush();
+}
+
+void ActionLogWriter::flush() {
+	if (!outFile.is_open() || buffer.empty()) return;
+	outFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	outFile.flush();
+	buffer.clear();
+}
+
+ActionLogReader::ActionLogReader() :
+	position(0),
+	lastTime(0),
+	startTime(0),
+	startMoney(0) {
+}
+
+bool ActionLogReader::open(const std::string& filename) {
+	std::ifstream inFile(filename, std::ios::binary);
+	if (!inFile.is_open()) {
+		coreError() << "No action log found" << std::endl;
+		return false;
+	}
+	data.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+
+	if (data.size() < sizeof(LOG_MAGIC) + 1 ||
+		data.compare(0, sizeof(LOG_MAGIC), LOG_MAGIC, sizeof(LOG_MAGIC)) != 0) {
+		coreError() << "Not an action log: " << filename << std::endl;
+		return false;
+	}
+	if (static_cast<std::uint8_t>(data[sizeof(LOG_MAGIC)]) != LOG_VERSION) {
+		coreError() << "Unsupported action log version" << std::endl;
+		return false;
+	}
+
+	position = sizeof(LOG_MAGIC) + 1;
+	std::uint64_t start, money;
+	if (!getVarint(start) || !getVarint(money)) {
+		coreError() << "Error reading action log header" << std::endl;
+		return false;
+	}
+	startTime = static_cast<std::time_t>(start);
+	startMoney = static_cast<int>(unzigzag(money));
+	lastTime = startTime;
+	return true;
+}
+
+bool ActionLogReader::getVarint(std::uint64_t& value) {
+	value = 0;
+	for (int shift = 0; shift < 64 && position < data.size(); shift += 7) {
+		std::uint8_t byte = static_cast<std::uint8_t>(data[position++]);
+		value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) return true;
+	}
+	return false;
+}
+
+bool ActionLogReader::next(ActionRecord& record) {
+	if (position >= data.size()) return false;
+
+	record.action = static_cast<PetAction>(data[position++]);
+	std::uint64_t delta;
+	if (!getVarint(delta)) return false;
+	lastTime += static_cast<std::time_t>(unzigzag(delta));
+	record.time = lastTime;
+	record.argument = 0;
+	record.name.clear();
+
+	switch (record.action) {
+	case ACTION_UPDATE:
+	case ACTION_PLAY:
+	case ACTION_SLEEP:
+	case ACTION_CLEAN:
+		return true;
+	case ACTION_USE_ITEM:
+	case ACTION_BUY_ITEM:
+		return getVarint(record.argument);
+	case ACTION_NEW_PET: {
+		std::uint64_t length;
+		if (!getVarint(record.argument) || !getVarint(length) || length > data.size() - position) {
+			return false;
+		}
+		record.name.assign(data, position, static_cast<size_t>(length));
+		position += static_cast<size_t>(length);
+		return true;
+	}
+	default:
+		coreError() << "Unknown action " << static_cast<int>(record.action) << " in action log" << std::endl;
+		return false;
+	}
+}
+
+std::time_t ActionLogReader::getStartTime() const { return startTime; }
+int ActionLogReader::getStartMoney() const { return startMoney; }
+
+bool replayActionLog(const std::string& snapshotFile, const std::string& logFile,
+	FixedStepClock& clock, std::unique_ptr<Pet>& pet, std::unique_ptr<PetShop>& shop, ReplayStats& stats) {
+	stats = { 0, 0, 0 };
+
+	ActionLogReader reader;
+	if (!reader.open(logFile)) return false;
+
+	clock.advanceTo(reader.getStartTime());
+	pet = std::make_unique<Pet>("Tama kun", clock);
+	if (!pet->loadPetFromFile(snapshotFile)) return false;
+
+	shop = std::make_unique<PetShop>();
+	shop->addMoney(reader.getStartMoney() - shop->getMoney());
+
+	ActionRecord record;
+	while (reader.next(record)) {
+		clock.advanceTo(record.time);
+		stats.records++;
+
+		switch (record.action) {
+		case ACTION_UPDATE:
+			pet->update(record.time);
+			stats.updates++;
+			continue;
+		case ACTION_PLAY: pet->play(); break;
+		case ACTION_SLEEP: pet->sleep(); break;
+		case ACTION_CLEAN: pet->clean(); break;
+		case ACTION_USE_ITEM:
+			pet->useItemFromInventory(pet->getInventory().findItem(static_cast<ItemId>(record.argument)));
+			break;
+		case ACTION_BUY_ITEM: shop->buyItem(static_cast<size_t>(record.argument), pet.get(), record.time); break;
+		case ACTION_NEW_PET:
+			pet = std::make_unique<Pet>(record.name, clock);
+			if (record.argument) {
+				shop = std::make_unique<PetShop>();
+			}
+			break;
+		}
+		stats.actions++;
+	}
+	return true;
+}
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <limits>
+#include "autosaver.h"
+
+Autosaver::Autosaver(const std::string& saveFile, double interval, bool background) :
+	filename(saveFile),
+	intervalSeconds(interval),
+	lastSaveTime(SteadyClock::now()),
+	savedPet(nullptr),
+	savedPetGeneration(0),
+	saveCount(0),
+	statsLive(false) {
+	if (background) {
+		worker = std::make_unique<SaveWorker>(filename);
+	}
+}
+
+void Autosaver::setInterval(double seconds) { intervalSeconds = seconds; }
+double Autosaver::getInterval() const { return intervalSeconds; }
+void Autosaver::setStatsLive(bool live) {
+	// The baseline counted the other generation, so it says nothing about the new mode
+	if (live != statsLive) savedPet = nullptr;
+	statsLive = live;
+}
+
+bool Autosaver::isDirty(const Pet& pet) const {
+	// A different pet object (e.g. a newly created one) is always unsaved
+	std::uint64_t petGeneration = statsLive ? pet.getInventoryGeneration() : pet.getGeneration();
+	return &pet != savedPet || petGeneration != savedPetGeneration;
+}
+
+bool Autosaver::maybeSave(const Pet& pet, SteadyClock::time_point now) {
+	if (std::chrono::duration<double>(now - lastSaveTime).count() < intervalSeconds) return false;
+	if (!isDirty(pet)) return false;
+
+	// Retry after a full interval even if the write fails
+	lastSaveTime = now;
+	return flush(pet);
+}
+
+double Autosaver::secondsUntilSave(const Pet& pet, SteadyClock::time_point now) const {
+	if (!isDirty(pet)) return std::numeric_limits<double>::infinity();
+	return std::max(0.0, intervalSeconds - std::chrono::duration<double>(now - lastSaveTime).count());
+}
+
+bool Autosaver::flush(const Pet& pet) {
+	if (!isDirty(pet)) return false;
+	if (worker) {
+		PetSnapshot snapshot = pet.snapshot();
+		worker->submit(snapshot);
+	}
+	else if (!pet.savePetToFile(filename)) {
+		return false;
+	}
+
+	markSaved(pet);
+	saveCount++;
+	return true;
+}
+
+void Autosaver::finish() {
+	if (worker) worker->stop();
+}
+
+void Autosaver::markSaved(const Pet& pet) {
+	savedPet = &pet;
+	savedPetGeneration = statsLive ? pet.getInventoryGeneration() : pet.getGeneration();
+}
+
+size_t Autosaver::getSaveCount() const { return saveCount; }
@@ -0,0 +1,145 @@
+#include <fstream>
+#include <iostream>
+#include "balance.h"
+#include "itemCatalog.h"
+#include "coreLog.h"
+
+constinit BalanceTable activeBalance = DEFAULT_BALANCE;
+
+namespace {
+
+// Stats live in 0..MAX_STAT, so no rate, threshold or effect needs more. Prices, money and
+// stock are capped so that sums of them (a batch cost, a day's allowance) stay far from INT_MAX.
+constexpr int MAX_PRICE = 1000000;
+constexpr int MAX_MONEY = 1000000;
+constexpr int MAX_STOCK = 1000000;
+// A year of game time; longer would not be noticed, and seconds stay well inside int
+constexpr int MAX_AGE_INTERVAL_MINUTES = 365 * 24 * 60;
+constexpr int MAX_DEATH_CONDITION_HOURS = 365 * 24;
+
+bool inRange(int value, int low, int high) {
+	return value >= low && value <= high;
+}
+
+bool setItemValue(BalanceTable& table, const std::string& key, int value) {
+	size_t dot = key.rfind('.');
+	if (dot == std::string::npos) return false;
+
+	std::string itemName = key.substr(0, dot);
+	std::string field = key.substr(dot + 1);
+	for (CatalogEntry& entry : table.items) {
+		if (itemName != entry.name) continue;
+		if (field == "price") entry.price = value;
+		else if (field == "effect") entry.effect = value;
+		else if (field == "sideEffect") entry.sideEffect = value;
+		else return false;
+		return true;
+	}
+	return false;
+}
+
+}
+
+bool loadBalanceOverride(const std::string& filename) {
+	std::ifstream inFile(filename);
+	if (!inFile.is_open()) {
+		coreError() << "Failed to open balance file: " << filename << std::endl;
+		return false;
+	}
+
+	BalanceTable table = DEFAULT_BALANCE;
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(inFile, line)) {
+		lineNumber++;
+		line = line.substr(0, line.find('#'));
+		size_t equals = line.find('=');
+		if (equals == std::string::npos) continue;
+
+		std::string key = line.substr(0, equals);
+		std::string value = line.substr(equals + 1);
+		key.erase(0, key.find_first_not_of(" \t"));
+		key.erase(key.find_last_not_of(" \t\r") + 1);
+		value.erase(0, value.find_first_not_of(" \t"));
+		value.erase(value.find_last_not_of(" \t\r") + 1);
+
+		int number;
+		try {
+			number = std::stoi(value);
+		}
+		catch (const std::exception&) {
+			coreError() << filename << ":" << lineNumber << ": bad value for " << key << std::endl;
+			return false;
+		}
+
+		bool known = false;
+#define BALANCE_VALUE(field, value) if (key == #field) { table.field = number; known = true; }
+#include "balance.def"
+		if (!known && !setItemValue(table, key, number)) {
+			coreError() << filename << ":" << lineNumber << ": unknown balance key " << key << std::endl;
+			return false;
+		}
+	}
+
+	// Fast-forwarding divides by these and assumes stats never decay backwards. Rates are
+	// multiplied by up to MAX_DECAY_MINUTES in int, which MAX_STAT keeps small.
+	if (!inRange(table.hungerPerMinute, 1, MAX_STAT) || !inRange(table.happinessDecayPerMinute, 0, MAX_STAT) ||
+		!inRange(table.energyDecayPerMinute, 0, MAX_STAT) || !inRange(table.cleanlinessDecayPerMinute, 0, MAX_STAT)) {
+		coreError() << "hungerPerMinute must be 1..100, other decay rates 0..100" << std::endl;
+		return false;
+	}
+	if (!inRange(table.ageIntervalMinutes, 1, MAX_AGE_INTERVAL_MINUTES)) {
+		coreError() << "ageIntervalMinutes must be 1.." << MAX_AGE_INTERVAL_MINUTES << std::endl;
+		return false;
+	}
+
+	// Zero hours would kill a pet the moment it turns critical
+	if (!inRange(table.deathConditionHours, 1, MAX_DEATH_CONDITION_HOURS)) {
+		coreError() << "deathConditionHours must be 1.." << MAX_DEATH_CONDITION_HOURS << std::endl;
+		return false;
+	}
+
+	// Everything compared with or added to a stat, which never leaves 0..100
+	const int statValues[] = {
+		table.criticalHunger, table.criticalHealth,
+		table.startHunger, table.startHappiness, table.startEnergy, table.startCleanliness, table.startHealth,
+		table.playMinEnergy, table.playHappiness, table.playEnergyCost, table.playHunger,
+		table.sleepEnergy, table.sleepHunger, table.cleanHappiness,
+		table.moodHungryAbove, table.moodTiredBelow, table.moodDirtyBelow,
+		table.moodSickBelow, table.moodSadBelow, table.moodHappyAbove
+	};
+	for (int value : statValues) {
+		if (!inRange(value, 0, MAX_STAT)) {
+			coreError() << "Critical thresholds, start stats, care action and mood values must be 0..100" << std::endl;
+			return false;
+		}
+	}
+
+	for (const CatalogEntry& entry : table.items) {
+		if (!inRange(entry.price, 0, MAX_PRICE) || !inRange(entry.effect, 0, MAX_STAT) || !inRange(entry.sideEffect, 0, MAX_STAT)) {
+			coreError() << entry.name << ": price must be 0.." << MAX_PRICE << ", effect and sideEffect 0..100" << std::endl;
+			return false;
+		}
+	}
+
+	if (!inRange(table.startingMoney, 0, MAX_MONEY) || !inRange(table.shopStockPerItem, 0, MAX_STOCK) ||
+		!inRange(table.shopRestockMinutes, 1, MAX_AGE_INTERVAL_MINUTES)) {
+		coreError() << "startingMoney and shopStockPerItem must be 0.." << MAX_STOCK
+			<< ", shopRestockMinutes 1.." << MAX_AGE_INTERVAL_MINUTES << std::endl;
+		return false;
+	}
+
+	activeBalance = table;
+	ItemCatalog::reloadBalance();
+	return true;
+}
+
+ScopedBalance::ScopedBalance(const BalanceTable& table) : previous(activeBalance) {
+	activeBalance = table;
+	ItemCatalog::reloadBalance();
+}
+
+ScopedBalance::~ScopedBalance() {
+	activeBalance = previous;
+	ItemCatalog::reloadBalance();
+}
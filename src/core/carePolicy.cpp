@@ -0,0 +1,155 @@
+#include <fstream>
+#include <iostream>
+#include <random>
+#include "carePolicy.h"
+#include "clock.h"
+#include "shop.h"
+#include "coreLog.h"
+
+namespace {
+
+// Same base time for every simulation so results only depend on the seed
+constexpr std::time_t SIMULATION_START = 1700000000;
+
+// The configured item if the pet holds it, otherwise any item of the same type
+bool useItem(Pet& pet, ItemId preferred) {
+	const Inventory& inventory = pet.getInventory();
+	InventoryHandle handle = inventory.findItem(preferred);
+	if (inventory.find(handle)) return pet.useItemFromInventory(handle);
+
+	auto stacks = inventory.getHandlesByType(ItemCatalog::get().item(preferred).getType());
+	return !stacks.empty() && pet.useItemFromInventory(stacks.front());
+}
+
+bool buyItem(PetShop& shop, Pet& pet, ItemId id, std::time_t now) {
+	const auto& items = shop.getShopItems();
+	for (size_t i = 0; i < items.size(); i++) {
+		if (items[i] == id) {
+			return shop.buyItem(i, &pet, now);
+		}
+	}
+	return false;
+}
+
+bool findPolicyItem(const std::string& itemName, ItemType type, ItemId& id) {
+	if (!ItemCatalog::get().find(itemName, id)) {
+		coreError() << "Unknown policy item " << itemName << std::endl;
+		return false;
+	}
+	if (ItemCatalog::get().item(id).getType() != type) {
+		coreError() << itemName << " is not a " << itemTypeName(type) << " item" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+}
+
+bool loadCarePolicy(const std::string& filename, CarePolicy& policy) {
+	std::ifstream inFile(filename);
+	if (!inFile.is_open()) {
+		coreError() << "Failed to open policy file: " << filename << std::endl;
+		return false;
+	}
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(inFile, line)) {
+		lineNumber++;
+		line = line.substr(0, line.find('#'));
+		size_t equals = line.find('=');
+		if (equals == std::string::npos) continue;
+
+		std::string key = line.substr(0, equals);
+		std::string value = line.substr(equals + 1);
+		key.erase(0, key.find_first_not_of(" \t"));
+		key.erase(key.find_last_not_of(" \t\r") + 1);
+		value.erase(0, value.find_first_not_of(" \t"));
+		value.erase(value.find_last_not_of(" \t\r") + 1);
+
+		try {
+			if (key == "checkIntervalMinutes") policy.checkIntervalMinutes = std::stoi(value);
+			else if (key == "attentiveness") policy.attentiveness = std::stod(value);
+			else if (key == "feedAtHunger") policy.feedAtHunger = std::stoi(value);
+			else if (key == "medicineBelowHealth") policy.medicineBelowHealth = std::stoi(value);
+			else if (key == "sleepBelowEnergy") policy.sleepBelowEnergy = std::stoi(value);
+			else if (key == "cleanBelowCleanliness") policy.cleanBelowCleanliness = std::stoi(value);
+			else if (key == "playBelowHappiness") policy.playBelowHappiness = std::stoi(value);
+			else if (key == "foodItem") policy.foodItem = value;
+			else if (key == "medicineItem") policy.medicineItem = value;
+			else if (key == "allowancePerDay") policy.allowancePerDay = std::stoi(value);
+			else if (key == "maxDays") policy.maxDays = std::stoi(value);
+			else {
+				coreError() << filename << ":" << lineNumber << ": unknown policy key " << key << std::endl;
+				return false;
+			}
+		}
+		catch (const std::exception&) {
+			coreError() << filename << ":" << lineNumber << ": bad value for " << key << std::endl;
+			return false;
+		}
+	}
+
+	if (policy.checkIntervalMinutes <= 0 || policy.maxDays <= 0) {
+		coreError() << "checkIntervalMinutes and maxDays must be positive" << std::endl;
+		return false;
+	}
+	// bernoulli_distribution is undefined outside [0, 1]; the negated test also rejects NaN
+	if (!(policy.attentiveness >= 0.0 && policy.attentiveness <= 1.0)) {
+		coreError() << "attentiveness must be between 0 and 1" << std::endl;
+		return false;
+	}
+	ItemId id;
+	return findPolicyItem(policy.foodItem, ITEM_FOOD, id) && findPolicyItem(policy.medicineItem, ITEM_MEDICINE, id);
+}
+
+CareOutcome simulateCare(const CarePolicy& policy, std::uint64_t seed) {
+	std::mt19937_64 rng(seed);
+	std::bernoulli_distribution attends(policy.attentiveness);
+
+	FixedStepClock clock(SIMULATION_START, static_cast<std::time_t>(policy.checkIntervalMinutes) * 60);
+	Pet pet("Sim", clock);
+	PetShop shop;
+
+	CareOutcome outcome = { false, 0, 0, DEATH_NONE };
+	ItemId foodId;
+	ItemId medicineId;
+	if (!findPolicyItem(policy.foodItem, ITEM_FOOD, foodId) || !findPolicyItem(policy.medicineItem, ITEM_MEDICINE, medicineId)) {
+		return outcome;
+	}
+	int coinsEarned = 0;
+	const int startingMoney = shop.getMoney();
+
+	while (pet.getIsAlive() && pet.getAge() < policy.maxDays) {
+		clock.advance();
+		FastForwardResult step = pet.advanceTo(clock.now());
+		if (step.daysAged > 0) {
+			shop.addMoney(step.daysAged * policy.allowancePerDay);
+			coinsEarned += step.daysAged * policy.allowancePerDay;
+		}
+		if (!pet.getIsAlive()) {
+			outcome.deathCause = step.deathCause;
+			break;
+		}
+		if (!attends(rng)) continue;
+
+		if (pet.getHunger() >= policy.feedAtHunger) {
+			if (!useItem(pet, foodId) && buyItem(shop, pet, foodId, clock.now())) {
+				useItem(pet, foodId);
+			}
+		}
+		if (pet.getHealth() < policy.medicineBelowHealth) {
+			if (!useItem(pet, medicineId) && buyItem(shop, pet, medicineId, clock.now())) {
+				useItem(pet, medicineId);
+			}
+		}
+		if (pet.getEnergy() < policy.sleepBelowEnergy) pet.sleep();
+		if (pet.getCleanliness() < policy.cleanBelowCleanliness) pet.clean();
+		if (pet.getHappiness() < policy.playBelowHappiness) pet.play();
+	}
+
+	outcome.survived = pet.getIsAlive();
+	outcome.age = pet.getAge();
+	outcome.coinsSpent = startingMoney + coinsEarned - shop.getMoney();
+	return outcome;
+}
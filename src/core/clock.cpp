@@ -0,0 +1,33 @@
+#include "clock.h"
+
+const Clock& Clock::wall() {
+	static const WallClock wallClock;
+	return wallClock;
+}
+
+std::time_t WallClock::now() const {
+	return std::time(nullptr);
+}
+
+FixedStepClock::FixedStepClock(std::time_t start, std::time_t step) :
+	current(start),
+	stepSeconds(step) {
+}
+
+std::time_t FixedStepClock::now() const { return current; }
+void FixedStepClock::advance() { current += stepSeconds; }
+void FixedStepClock::advanceTo(std::time_t time) { current = time; }
+std::time_t FixedStepClock::getStep() const { return stepSeconds; }
+
+AcceleratedClock::AcceleratedClock(double speedFactor, std::time_t startTime) :
+	start(startTime),
+	realStart(std::chrono::steady_clock::now()),
+	factor(speedFactor) {
+}
+
+std::time_t AcceleratedClock::now() const {
+	double realSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - realStart).count();
+	return start + static_cast<std::time_t>(realSeconds * factor);
+}
+
+double AcceleratedClock::getFactor() const { return factor; }
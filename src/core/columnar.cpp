@@ -0,0 +1,406 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include "columnar.h"
+#include "saveFormat.h"
+#include "coreLog.h"
+
+namespace {
+
+const char COLUMNAR_MAGIC[8] = { 'T', 'A', 'M', 'A', 'C', 'O', 'L', '1' };
+
+static_assert(sizeof(ColumnChunk) == 32, "ColumnChunk layout changed");
+static_assert(sizeof(ColumnarTail) == 32, "ColumnarTail layout changed");
+
+const char* const COLUMN_NAMES[COLUMN_COUNT] = {
+	"hunger", "happiness", "energy", "cleanliness", "health", "age",
+	"isAlive", "isInCriticalHunger", "isInCriticalHealth",
+	"lastUpdateTime", "lastAgeTime", "birthTime", "criticalHungerStartTime", "criticalHealthStartTime",
+};
+
+bool isTimeColumn(int column) {
+	return column >= COLUMN_LAST_UPDATE_TIME;
+}
+
+int bitsNeeded(std::uint64_t value) {
+	int bits = 0;
+	while (value) {
+		bits++;
+		value >>= 1;
+	}
+	return bits;
+}
+
+size_t packedBytes(size_t count, int bitWidth) {
+	// One spare word so readers can always load two words around a value
+	return ((count * static_cast<size_t>(bitWidth) + 63) / 64 + 1) * sizeof(std::uint64_t);
+}
+
+void packBits(const std::vector<std::uint64_t>& values, int bitWidth, std::string& out) {
+	std::vector<std::uint64_t> words(packedBytes(values.size(), bitWidth) / sizeof(std::uint64_t), 0);
+	if (bitWidth > 0) {
+		for (size_t i = 0; i < values.size(); i++) {
+			size_t bit = i * static_cast<size_t>(bitWidth);
+			size_t word = bit >> 6;
+			unsigned shift = static_cast<unsigned>(bit & 63);
+			words[word] |= values[i] << shift;
+			if (shift + bitWidth > 64) {
+				words[word + 1] |= values[i] >> (64 - shift);
+			}
+		}
+	}
+	for (std::uint64_t& word : words) word = littleEndian(word);
+	out.assign(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(std::uint64_t));
+}
+
+std::uint64_t loadWord(const char* data, size_t word) {
+	std::uint64_t value;
+	std::memcpy(&value, data + word * sizeof(std::uint64_t), sizeof(value));
+	return littleEndian(value);
+}
+
+std::uint64_t unpackBits(const char* data, size_t index, int bitWidth) {
+	if (bitWidth == 0) return 0;
+	size_t bit = index * static_cast<size_t>(bitWidth);
+	size_t word = bit >> 6;
+	unsigned shift = static_cast<unsigned>(bit & 63);
+	std::uint64_t value = loadWord(data, word) >> shift;
+	if (shift + bitWidth > 64) {
+		value |= loadWord(data, word + 1) << (64 - shift);
+	}
+	return bitWidth == 64 ? value : value & ((std::uint64_t(1) << bitWidth) - 1);
+}
+
+}
+
+const char* columnName(PetColumn column) {
+	return column < COLUMN_COUNT ? COLUMN_NAMES[column] : "unknown";
+}
+
+std::int64_t columnValue(const PetState& state, PetColumn column) {
+	switch (column) {
+	case COLUMN_HUNGER: return state.hunger;
+	case COLUMN_HAPPINESS: return state.happiness;
+	case COLUMN_ENERGY: return state.energy;
+	case COLUMN_CLEANLINESS: return state.cleanliness;
+	case COLUMN_HEALTH: return state.health;
+	case COLUMN_AGE: return state.age;
+	case COLUMN_IS_ALIVE: return state.isAlive ? 1 : 0;
+	case COLUMN_IN_CRITICAL_HUNGER: return state.isInCriticalHunger ? 1 : 0;
+	case COLUMN_IN_CRITICAL_HEALTH: return state.isInCriticalHealth ? 1 : 0;
+	case COLUMN_LAST_UPDATE_TIME: return state.lastUpdateTime;
+	case COLUMN_LAST_AGE_TIME: return state.lastAgeTime;
+	case COLUMN_BIRTH_TIME: return state.birthTime;
+	case COLUMN_CRITICAL_HUNGER_START: return state.criticalHungerStartTime;
+	case COLUMN_CRITICAL_HEALTH_START: return state.criticalHealthStartTime;
+	default: return 0;
+	}
+}
+
+ColumnarWriter::ColumnarWriter() :
+	position(0),
+	rowGroupSize(1 << 16),
+	allowPacking(true),
+	rowCount(0) {
+}
+
+ColumnarWriter::~ColumnarWriter() {
+	if (outFile.is_open()) close();
+}
+
+bool ColumnarWriter::open(const std::string& filename, size_t groupSize, bool packing) {
+	if (!createSaveDirectory(filename)) return false;
+	outFile.open(filename, std::ios::binary | std::ios::trunc);
+	if (!outFile.is_open()) {
+		coreError() << "Failed to open columnar file for writing" << std::endl;
+		return false;
+	}
+
+	rowGroupSize = std::max<size_t>(groupSize, 1);
+	allowPacking = packing;
+	rowGroupOffsets.clear();
+	rowCount = 0;
+	position = 0;
+	for (auto& column : columns) {
+		column.clear();
+		column.reserve(rowGroupSize);
+	}
+	return writeBytes(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+}
+
+bool ColumnarWriter::writeBytes(const void* data, size_t size) {
+	if (!outFile.write(static_cast<const char*>(data), static_cast<std::streamsize>(size))) {
+		coreError() << "Failed to write columnar file" << std::endl;
+		return false;
+	}
+	position += size;
+	return true;
+}
+
+bool ColumnarWriter::append(const PetState& state) {
+	if (!outFile.is_open()) return false;
+	for (int c = 0; c < COLUMN_COUNT; c++) {
+		columns[c].push_back(columnValue(state, static_cast<PetColumn>(c)));
+	}
+	rowCount++;
+	return columns[0].size() < rowGroupSize || writeRowGroup();
+}
+
+bool ColumnarWriter::writeRowGroup() {
+	size_t count = columns[0].size();
+	if (count == 0) return true;
+
+	ColumnarGroupHeader header = {};
+	header.rowCount = count;
+	std::string chunks[COLUMN_COUNT];
+	std::vector<std::uint64_t> packed(count);
+
+	std::uint64_t chunkOffset = position + sizeof(ColumnarGroupHeader);
+	for (int c = 0; c < COLUMN_COUNT; c++) {
+		const std::vector<std::int64_t>& values = columns[c];
+		ColumnChunk& chunk = header.columns[c];
+		int plainWidth = isTimeColumn(c) ? 64 : 32;
+
+		// Size of each candidate encoding; differences use wrapping unsigned arithmetic
+		auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end());
+		int rangeBits = bitsNeeded(static_cast<std::uint64_t>(*maxIt) - static_cast<std::uint64_t>(*minIt));
+		std::int64_t minDelta = 0;
+		std::uint64_t maxDelta = 0;
+		for (size_t i = 1; i < count; i++) {
+			std::int64_t delta = static_cast<std::int64_t>(static_cast<std::uint64_t>(values[i]) - static_cast<std::uint64_t>(values[i - 1]));
+			minDelta = i == 1 ? delta : std::min(minDelta, delta);
+		}
+		for (size_t i = 1; i < count; i++) {
+			std::uint64_t delta = static_cast<std::uint64_t>(values[i]) - static_cast<std::uint64_t>(values[i - 1]);
+			maxDelta = std::max(maxDelta, delta - static_cast<std::uint64_t>(minDelta));
+		}
+		int deltaBits = bitsNeeded(maxDelta);
+
+		size_t plainSize = count * static_cast<size_t>(plainWidth / 8);
+		size_t bitpackSize = packedBytes(count, rangeBits);
+		size_t deltaSize = packedBytes(count, deltaBits);
+
+		if (allowPacking && bitpackSize < plainSize && bitpackSize <= deltaSize) {
+			chunk.encoding = ENCODING_BITPACK;
+			chunk.bitWidth = static_cast<std::uint8_t>(rangeBits);
+			chunk.base = *minIt;
+			for (size_t i = 0; i < count; i++) {
+				packed[i] = static_cast<std::uint64_t>(values[i]) - static_cast<std::uint64_t>(*minIt);
+			}
+			packBits(packed, rangeBits, chunks[c]);
+		}
+		else if (allowPacking && deltaSize < plainSize) {
+			chunk.encoding = ENCODING_DELTA;
+			chunk.bitWidth = static_cast<std::uint8_t>(deltaBits);
+			chunk.base = values[0];
+			chunk.reference = minDelta;
+			packed[0] = 0;
+			for (size_t i = 1; i < count; i++) {
+				packed[i] = static_cast<std::uint64_t>(values[i]) - static_cast<std::uint64_t>(values[i - 1]) -
+					static_cast<std::uint64_t>(minDelta);
+			}
+			packBits(packed, deltaBits, chunks[c]);
+		}
+		else {
+			chunk.encoding = ENCODING_PLAIN;
+			chunk.bitWidth = static_cast<std::uint8_t>(plainWidth);
+			chunks[c].resize(plainSize);
+			char* out = chunks[c].data();
+			for (size_t i = 0; i < count; i++) {
+				if (plainWidth == 32) {
+					std::int32_t value = littleEndian(static_cast<std::int32_t>(values[i]));
+					std::memcpy(out + i * sizeof(value), &value, sizeof(value));
+				}
+				else {
+					std::int64_t value = littleEndian(values[i]);
+					std::memcpy(out + i * sizeof(value), &value, sizeof(value));
+				}
+			}
+			chunks[c].resize((plainSize + 7) & ~size_t(7), '\0');
+		}
+
+		chunk.byteLength = static_cast<std::uint32_t>(chunks[c].size());
+		chunk.offset = chunkOffset;
+		chunkOffset += chunks[c].size();
+	}
+
+	ColumnarGroupHeader stored = header;
+	stored.rowCount = littleEndian(stored.rowCount);
+	for (ColumnChunk& chunk : stored.columns) {
+		chunk.byteLength = littleEndian(chunk.byteLength);
+		chunk.base = littleEndian(chunk.base);
+		chunk.reference = littleEndian(chunk.reference);
+		chunk.offset = littleEndian(chunk.offset);
+	}
+
+	rowGroupOffsets.push_back(position);
+	if (!writeBytes(&stored, sizeof(stored))) return false;
+	for (const std::string& chunk : chunks) {
+		if (!writeBytes(chunk.data(), chunk.size())) return false;
+	}
+	for (auto& column : columns) column.clear();
+	return true;
+}
+
+bool ColumnarWriter::close() {
+	if (!outFile.is_open()) return false;
+	bool ok = writeRowGroup();
+
+	ColumnarTail tail = {};
+	tail.rowGroupCount = littleEndian<std::uint64_t>(rowGroupOffsets.size());
+	tail.rowCount = littleEndian(rowCount);
+	tail.footerOffset = littleEndian(position);
+	std::memcpy(tail.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+
+	for (std::uint64_t offset : rowGroupOffsets) {
+		std::uint64_t stored = littleEndian(offset);
+		ok = ok && writeBytes(&stored, sizeof(stored));
+	}
+	ok = ok && writeBytes(&tail, sizeof(tail));
+	outFile.close();
+	return ok && !outFile.fail();
+}
+
+std::uint64_t ColumnarWriter::getRowCount() const { return rowCount; }
+
+ColumnView::ColumnView(const char* chunkData, size_t rowCount, const ColumnChunk& descriptor) :
+	data(chunkData),
+	count(rowCount),
+	chunk(descriptor) {
+}
+
+size_t ColumnView::size() const { return count; }
+ColumnEncoding ColumnView::getEncoding() const { return static_cast<ColumnEncoding>(chunk.encoding); }
+int ColumnView::getBitWidth() const { return chunk.bitWidth; }
+
+const std::int32_t* ColumnView::plain32() const {
+	return chunk.encoding == ENCODING_PLAIN && chunk.bitWidth == 32 ? reinterpret_cast<const std::int32_t*>(data) : nullptr;
+}
+
+const std::int64_t* ColumnView::plain64() const {
+	return chunk.encoding == ENCODING_PLAIN && chunk.bitWidth == 64 ? reinterpret_cast<const std::int64_t*>(data) : nullptr;
+}
+
+std::int64_t ColumnView::get(size_t index) const {
+	switch (chunk.encoding) {
+	case ENCODING_BITPACK:
+		return static_cast<std::int64_t>(static_cast<std::uint64_t>(chunk.base) + unpackBits(data, index, chunk.bitWidth));
+	case ENCODING_DELTA: {
+		std::uint64_t value = static_cast<std::uint64_t>(chunk.base);
+		for (size_t i = 1; i <= index; i++) {
+			value += unpackBits(data, i, chunk.bitWidth) + static_cast<std::uint64_t>(chunk.reference);
+		}
+		return static_cast<std::int64_t>(value);
+	}
+	default:
+		return chunk.bitWidth == 32 ? littleEndian(plain32()[index]) : littleEndian(plain64()[index]);
+	}
+}
+
+void ColumnView::decode(std::int64_t* out) const {
+	if (count == 0) return;
+	switch (chunk.encoding) {
+	case ENCODING_BITPACK:
+		for (size_t i = 0; i < count; i++) {
+			out[i] = static_cast<std::int64_t>(static_cast<std::uint64_t>(chunk.base) + unpackBits(data, i, chunk.bitWidth));
+		}
+		break;
+	case ENCODING_DELTA: {
+		std::uint64_t value = static_cast<std::uint64_t>(chunk.base);
+		out[0] = chunk.base;
+		for (size_t i = 1; i < count; i++) {
+			value += unpackBits(data, i, chunk.bitWidth) + static_cast<std::uint64_t>(chunk.reference);
+			out[i] = static_cast<std::int64_t>(value);
+		}
+		break;
+	}
+	default:
+		if (const std::int32_t* values32 = plain32()) {
+			for (size_t i = 0; i < count; i++) out[i] = littleEndian(values32[i]);
+		}
+		else {
+			const std::int64_t* values64 = plain64();
+			for (size_t i = 0; i < count; i++) out[i] = littleEndian(values64[i]);
+		}
+		break;
+	}
+}
+
+ColumnarReader::ColumnarReader() : rowCount(0) {}
+
+bool ColumnarReader::open(const std::string& filename) {
+	rowGroupOffsets.clear();
+	rowCount = 0;
+	if (!file.open(filename)) {
+		coreError() << "No columnar file found" << std::endl;
+		return false;
+	}
+
+	const char* data = file.getData();
+	size_t size = file.getSize();
+	ColumnarTail tail;
+	if (size < sizeof(COLUMNAR_MAGIC) + sizeof(tail) || std::memcmp(data, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC)) != 0) {
+		coreError() << "Not a columnar file: " << filename << std::endl;
+		return false;
+	}
+	std::memcpy(&tail, data + size - sizeof(tail), sizeof(tail));
+	std::uint64_t groupCount = littleEndian(tail.rowGroupCount);
+	std::uint64_t footerOffset = littleEndian(tail.footerOffset);
+	if (std::memcmp(tail.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC)) != 0 ||
+		footerOffset > size - sizeof(tail) ||
+		groupCount != (size - sizeof(tail) - footerOffset) / sizeof(std::uint64_t)) {
+		coreError() << "Columnar file footer is damaged" << std::endl;
+		return false;
+	}
+
+	// Check every chunk once so views never need bounds checks
+	std::uint64_t rows = 0;
+	for (std::uint64_t g = 0; g < groupCount; g++) {
+		std::uint64_t offset = loadWord(data + footerOffset, g);
+		if (offset % 8 != 0 || offset > footerOffset || footerOffset - offset < sizeof(ColumnarGroupHeader)) {
+			coreError() << "Columnar row group " << g << " is out of range" << std::endl;
+			return false;
+		}
+		const ColumnarGroupHeader* header = reinterpret_cast<const ColumnarGroupHeader*>(data + offset);
+		std::uint64_t groupRows = littleEndian(header->rowCount);
+		for (const ColumnChunk& chunk : header->columns) {
+			std::uint64_t chunkOffset = littleEndian(chunk.offset);
+			std::uint64_t length = littleEndian(chunk.byteLength);
+			std::uint64_t needed = chunk.encoding == ENCODING_PLAIN
+				? groupRows * (chunk.bitWidth / 8)
+				: packedBytes(static_cast<size_t>(groupRows), chunk.bitWidth);
+			if (chunkOffset % 8 != 0 || chunkOffset > footerOffset || length > footerOffset - chunkOffset ||
+				length < needed || chunk.encoding > ENCODING_DELTA || chunk.bitWidth > 64 ||
+				(chunk.encoding == ENCODING_PLAIN && chunk.bitWidth != 32 && chunk.bitWidth != 64)) {
+				coreError() << "Columnar row group " << g << " has a damaged column" << std::endl;
+				return false;
+			}
+		}
+		rowGroupOffsets.push_back(offset);
+		rows += groupRows;
+	}
+	if (rows != littleEndian(tail.rowCount)) {
+		coreError() << "Columnar row count does not match its row groups" << std::endl;
+		return false;
+	}
+	rowCount = rows;
+	return true;
+}
+
+std::uint64_t ColumnarReader::getRowCount() const { return rowCount; }
+size_t ColumnarReader::getRowGroupCount() const { return rowGroupOffsets.size(); }
+
+size_t ColumnarReader::getRowGroupSize(size_t group) const {
+	const ColumnarGroupHeader* header = reinterpret_cast<const ColumnarGroupHeader*>(file.getData() + rowGroupOffsets[group]);
+	return static_cast<size_t>(littleEndian(header->rowCount));
+}
+
+ColumnView ColumnarReader::column(size_t group, PetColumn column) const {
+	const ColumnarGroupHeader* header = reinterpret_cast<const ColumnarGroupHeader*>(file.getData() + rowGroupOffsets[group]);
+	ColumnChunk chunk = header->columns[column];
+	chunk.byteLength = littleEndian(chunk.byteLength);
+	chunk.base = littleEndian(chunk.base);
+	chunk.reference = littleEndian(chunk.reference);
+	chunk.offset = littleEndian(chunk.offset);
+	return ColumnView(file.getData() + chunk.offset, static_cast<size_t>(littleEndian(header->rowCount)), chunk);
+}
@@ -0,0 +1,32 @@
+#include <iostream>
+#include "coreLog.h"
+
+namespace {
+
+bool loggingEnabled = true;
+bool errorLoggingEnabled = true;
+
+// A stream without a buffer discards everything written to it. Every write still sets its
+// badbit, so each thread gets its own rather than racing on one shared stream.
+std::ostream& nullStream() {
+	thread_local std::ostream stream(nullptr);
+	return stream;
+}
+
+}
+
+std::ostream& coreLog() {
+	return loggingEnabled ? std::cout : nullStream();
+}
+
+std::ostream& coreError() {
+	return errorLoggingEnabled ? std::cerr : nullStream();
+}
+
+void setCoreLogging(bool enabled) {
+	loggingEnabled = enabled;
+}
+
+void setCoreErrorLogging(bool enabled) {
+	errorLoggingEnabled = enabled;
+}
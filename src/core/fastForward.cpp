@@ -0,0 +1,301 @@
+#include <algorithm>
+#include "fastForward.h"
+
+namespace {
+
+constexpr std::time_t SECONDS_PER_TICK = 60;
+
+std::time_t ageIntervalSeconds() {
+	return static_cast<std::time_t>(balance().ageIntervalMinutes) * 60;
+}
+
+std::time_t deathConditionSeconds() {
+	return static_cast<std::time_t>(balance().deathConditionHours) * 3600;
+}
+
+int clampStat(int value) {
+	return std::min(100, std::max(0, value));
+}
+
+int deriveHealth(int hunger, int happiness, int energy, int cleanliness) {
+	return 100 - ((hunger + (100 - happiness) + (100 - energy) + (100 - cleanliness)) / 4);
+}
+
+std::time_t ceilDiv(std::time_t a, std::time_t b) {
+	return (a + b - 1) / b;
+}
+
+// One update() at time t after any decay has been applied. Returns true if the pet died.
+bool checkAt(FastForwardResult& result, std::time_t t) {
+	PetState& s = result.state;
+
+	if (s.hunger >= balance().criticalHunger) {
+		if (!s.isInCriticalHunger) {
+			s.isInCriticalHunger = true;
+			s.criticalHungerStartTime = t;
+			result.hungerCriticalTime = t;
+		}
+		else if (t - s.criticalHungerStartTime >= deathConditionSeconds()) {
+			s.isAlive = false;
+			result.deathTime = t;
+			result.deathCause = DEATH_STARVATION;
+			return true;
+		}
+	}
+	else {
+		s.isInCriticalHunger = false;
+		s.criticalHungerStartTime = 0;
+	}
+
+	if (s.health <= balance().criticalHealth) {
+		if (!s.isInCriticalHealth) {
+			s.isInCriticalHealth = true;
+			s.criticalHealthStartTime = t;
+			result.healthCriticalTime = t;
+		}
+		else if (t - s.criticalHealthStartTime >= deathConditionSeconds()) {
+			s.isAlive = false;
+			result.deathTime = t;
+			result.deathCause = DEATH_ILLNESS;
+			return true;
+		}
+	}
+	else {
+		s.isInCriticalHealth = false;
+		s.criticalHealthStartTime = 0;
+	}
+
+	if (t - s.lastAgeTime >= ageIntervalSeconds()) {
+		int daysToAdd = static_cast<int>((t - s.lastAgeTime) / ageIntervalSeconds());
+		s.age += daysToAdd;
+		s.lastAgeTime += daysToAdd * ageIntervalSeconds();
+		result.daysAged += daysToAdd;
+	}
+	return false;
+}
+
+struct DecayedStats {
+	int hunger;
+	int happiness;
+	int energy;
+	int cleanliness;
+	int health;
+};
+
+DecayedStats decayedAfter(const PetState& s, std::time_t minutes) {
+	int m = static_cast<int>(std::min<std::time_t>(minutes, MAX_DECAY_MINUTES));
+	DecayedStats d;
+	d.hunger = clampStat(s.hunger + m * balance().hungerPerMinute);
+	d.happiness = clampStat(s.happiness - m * balance().happinessDecayPerMinute);
+	d.energy = clampStat(s.energy - m * balance().energyDecayPerMinute);
+	d.cleanliness = clampStat(s.cleanliness - m * balance().cleanlinessDecayPerMinute);
+	d.health = deriveHealth(d.hunger, d.happiness, d.energy, d.cleanliness);
+	return d;
+}
+
+// The update() calls covered by a step are numbered 1..ticks+1: one per whole minute,
+// then a final one at `now` that sees the same stats as the last tick.
+struct CallSchedule {
+	std::time_t start;
+	std::time_t ticks;
+	std::time_t now;
+
+	std::time_t timeOf(std::time_t call) const {
+		return call <= ticks ? start + call * SECONDS_PER_TICK : now;
+	}
+
+	// First call at or after time t, 0 if there is none
+	std::time_t firstCallAtOrAfter(std::time_t t) const {
+		if (ticks >= 1 && t <= start + ticks * SECONDS_PER_TICK) {
+			return std::max<std::time_t>(1, ceilDiv(t - start, SECONDS_PER_TICK));
+		}
+		return t <= now ? ticks + 1 : 0;
+	}
+};
+
+// How a critical window (hunger >= 80 or health <= 20) plays out over the calls
+struct CriticalPlan {
+	bool resetAtFirstCall;
+	std::time_t entryCall;   // Call that enters the critical state, 0 if none
+	std::time_t startTime;
+	std::time_t deathCall;   // Call that kills the pet, 0 if none
+};
+
+// firstCritical is the first call whose stats are critical; the predicate stays true afterwards
+CriticalPlan planCritical(const CallSchedule& calls, bool inCritical, std::time_t startTime, std::time_t firstCritical) {
+	CriticalPlan plan = { false, 0, startTime, 0 };
+
+	if (inCritical && firstCritical == 1) {
+		plan.deathCall = calls.firstCallAtOrAfter(startTime + deathConditionSeconds());
+		return plan;
+	}
+
+	plan.resetAtFirstCall = firstCritical != 1;
+	if (firstCritical > 0) {
+		plan.entryCall = firstCritical;
+		plan.startTime = calls.timeOf(firstCritical);
+		plan.deathCall = calls.firstCallAtOrAfter(plan.startTime + deathConditionSeconds());
+	}
+	return plan;
+}
+
+void applyCritical(const CriticalPlan& plan, std::time_t checkedUpTo, bool& inCritical, std::time_t& startTime, std::time_t& crossedAt) {
+	if (checkedUpTo >= 1 && plan.resetAtFirstCall) {
+		inCritical = false;
+		startTime = 0;
+	}
+	if (plan.entryCall > 0 && plan.entryCall <= checkedUpTo) {
+		inCritical = true;
+		startTime = plan.startTime;
+		crossedAt = plan.startTime;
+	}
+}
+
+}
+
+FastForwardResult fastForward(const PetState& state, std::time_t now) {
+	FastForwardResult result = { state, 0, 0, 0, DEATH_NONE, 0 };
+	if (!state.isAlive) return result;
+
+	const std::time_t t0 = state.lastUpdateTime;
+	const CallSchedule calls = { t0, now > t0 ? (now - t0) / SECONDS_PER_TICK : 0, now };
+
+	// First call at which hunger is critical; hunger only rises while decaying
+	std::time_t firstHungry = 0;
+	if (calls.ticks == 0) {
+		firstHungry = state.hunger >= balance().criticalHunger ? 1 : 0;
+	}
+	else {
+		std::time_t k = std::max<std::time_t>(1, ceilDiv(std::max(0, balance().criticalHunger - state.hunger), balance().hungerPerMinute));
+		firstHungry = k <= calls.ticks ? k : 0;
+	}
+
+	// First call at which health is critical; derived health never rises while decaying
+	std::time_t firstSick = 0;
+	if (calls.ticks == 0) {
+		firstSick = state.health <= balance().criticalHealth ? 1 : 0;
+	}
+	else {
+		std::time_t hi = std::min<std::time_t>(calls.ticks, MAX_DECAY_MINUTES);
+		if (decayedAfter(state, hi).health <= balance().criticalHealth) {
+			std::time_t lo = 1;
+			while (lo < hi) {
+				std::time_t mid = lo + (hi - lo) / 2;
+				if (decayedAfter(state, mid).health <= balance().criticalHealth) hi = mid;
+				else lo = mid + 1;
+			}
+			firstSick = lo;
+		}
+	}
+
+	CriticalPlan hungerPlan = planCritical(calls, state.isInCriticalHunger, state.criticalHungerStartTime, firstHungry);
+	CriticalPlan healthPlan = planCritical(calls, state.isInCriticalHealth, state.criticalHealthStartTime, firstSick);
+
+	// Hunger is checked first within a call, so it wins ties
+	std::time_t deathCall = 0;
+	if (hungerPlan.deathCall > 0 && (healthPlan.deathCall == 0 || hungerPlan.deathCall <= healthPlan.deathCall)) {
+		deathCall = hungerPlan.deathCall;
+		result.deathCause = DEATH_STARVATION;
+	}
+	else if (healthPlan.deathCall > 0) {
+		deathCall = healthPlan.deathCall;
+		result.deathCause = DEATH_ILLNESS;
+	}
+
+	const std::time_t lastCall = deathCall > 0 ? deathCall : calls.ticks + 1;
+	PetState& s = result.state;
+
+	const std::time_t minutesDecayed = std::min(lastCall, calls.ticks);
+	if (minutesDecayed >= 1) {
+		DecayedStats d = decayedAfter(state, minutesDecayed);
+		s.hunger = d.hunger;
+		s.happiness = d.happiness;
+		s.energy = d.energy;
+		s.cleanliness = d.cleanliness;
+		s.health = d.health;
+		s.lastUpdateTime = t0 + minutesDecayed * SECONDS_PER_TICK;
+	}
+
+	const std::time_t healthCheckedUpTo = result.deathCause == DEATH_STARVATION ? deathCall - 1 : lastCall;
+	applyCritical(hungerPlan, lastCall, s.isInCriticalHunger, s.criticalHungerStartTime, result.hungerCriticalTime);
+	applyCritical(healthPlan, healthCheckedUpTo, s.isInCriticalHealth, s.criticalHealthStartTime, result.healthCriticalTime);
+
+	// Aging runs after the critical checks, so not on the call that kills the pet
+	const std::time_t agedUpTo = deathCall > 0 ? deathCall - 1 : lastCall;
+	if (agedUpTo >= 1) {
+		std::time_t t = calls.timeOf(agedUpTo);
+		if (t - s.lastAgeTime >= ageIntervalSeconds()) {
+			int daysToAdd = static_cast<int>((t - s.lastAgeTime) / ageIntervalSeconds());
+			s.age += daysToAdd;
+			s.lastAgeTime += daysToAdd * ageIntervalSeconds();
+			result.daysAged = daysToAdd;
+		}
+	}
+
+	if (deathCall > 0) {
+		s.isAlive = false;
+		result.deathTime = calls.timeOf(deathCall);
+	}
+	return result;
+}
+
+FastForwardResult stepForward(const PetState& state, std::time_t now) {
+	FastForwardResult result = { state, 0, 0, 0, DEATH_NONE, 0 };
+	if (!state.isAlive) return result;
+
+	PetState& s = result.state;
+	const std::time_t t0 = state.lastUpdateTime;
+	const std::time_t ticks = now > t0 ? (now - t0) / SECONDS_PER_TICK : 0;
+
+	for (std::time_t k = 1; k <= ticks; k++) {
+		s.hunger = clampStat(s.hunger + balance().hungerPerMinute);
+		s.happiness = clampStat(s.happiness - balance().happinessDecayPerMinute);
+		s.energy = clampStat(s.energy - balance().energyDecayPerMinute);
+		s.cleanliness = clampStat(s.cleanliness - balance().cleanlinessDecayPerMinute);
+		s.health = deriveHealth(s.hunger, s.happiness, s.energy, s.cleanliness);
+		s.lastUpdateTime = t0 + k * SECONDS_PER_TICK;
+
+		if (checkAt(result, s.lastUpdateTime)) return result;
+	}
+
+	checkAt(result, now);
+	return result;
+}
+
+PetEvent nextPetEvent(const PetState& state) {
+	PetEvent next = { 0, PET_EVENT_NONE };
+	if (!state.isAlive) return next;
+
+	auto consider = [&next](std::time_t time, PetEventKind kind) {
+		if (next.kind == PET_EVENT_NONE || time < next.time) {
+			next = { time, kind };
+		}
+	};
+
+	// Stats changed by an action without a check yet, e.g. play() pushing hunger to 80
+	bool hungerPending = (state.hunger >= balance().criticalHunger) != state.isInCriticalHunger;
+	bool healthPending = (state.health <= balance().criticalHealth) != state.isInCriticalHealth;
+	if (hungerPending || healthPending) {
+		consider(state.lastUpdateTime, PET_EVENT_CRITICAL);
+	}
+
+	// Once every stat is saturated and health matches them, decay ticks change nothing
+	DecayedStats after = decayedAfter(state, 1);
+	bool decayChanges = after.hunger != state.hunger || after.happiness != state.happiness ||
+		after.energy != state.energy || after.cleanliness != state.cleanliness || after.health != state.health;
+	if (decayChanges) {
+		bool entersCritical = (after.hunger >= balance().criticalHunger && !state.isInCriticalHunger) ||
+			(after.health <= balance().criticalHealth && !state.isInCriticalHealth);
+		consider(state.lastUpdateTime + SECONDS_PER_TICK, entersCritical ? PET_EVENT_CRITICAL : PET_EVENT_DECAY);
+	}
+
+	if (state.isInCriticalHunger) {
+		consider(state.criticalHungerStartTime + deathConditionSeconds(), PET_EVENT_DEATH);
+	}
+	if (state.isInCriticalHealth) {
+		consider(state.criticalHealthStartTime + deathConditionSeconds(), PET_EVENT_DEATH);
+	}
+
+	consider(state.lastAgeTime + ageIntervalSeconds(), PET_EVENT_AGING);
+	return next;
+}
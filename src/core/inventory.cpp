@@ -0,0 +1,110 @@
+#include "inventory.h"
+
+bool Inventory::canAdd(ItemId id, std::uint64_t count) const {
+	if (!ItemCatalog::get().contains(id)) return false;
+	const InventoryStack* stack = find(findItem(id));
+	return (stack ? stack->count : 0) + count <= UINT32_MAX;
+}
+
+bool Inventory::add(ItemId id, std::uint32_t count) {
+	const ItemCatalog& catalog = ItemCatalog::get();
+	if (!canAdd(id, count)) return false;
+	if (count == 0) return true;
+
+	if (slotByItem.size() <= id) slotByItem.resize(catalog.size(), NO_SLOT);
+	if (slotByItem[id] != NO_SLOT) {
+		stacks[slots[slotByItem[id]].dense].count += count;
+		return true;
+	}
+
+	std::uint32_t slot;
+	if (!freeSlots.empty()) {
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else {
+		slot = static_cast<std::uint32_t>(slots.size());
+		slots.push_back({ 0, 0, 0 });
+	}
+	slots[slot].dense = static_cast<std::uint32_t>(stacks.size());
+	stacks.push_back({ id, count });
+	denseToSlot.push_back(slot);
+	slotByItem[id] = slot;
+	auto& typeHandles = handlesByType[catalog.item(id).getType()];
+	slots[slot].typeIndex = static_cast<std::uint32_t>(typeHandles.size());
+	typeHandles.push_back({ slot, slots[slot].generation });
+	return true;
+}
+
+bool Inventory::take(InventoryHandle handle) {
+	if (!find(handle)) return false;
+
+	std::uint32_t dense = slots[handle.slot].dense;
+	if (--stacks[dense].count > 0) return true;
+
+	// Stack used up: retire the handle and move the last stack into the gap
+	ItemId id = stacks[dense].catalogId;
+	auto& typeHandles = handlesByType[ItemCatalog::get().item(id).getType()];
+	std::uint32_t typeIndex = slots[handle.slot].typeIndex;
+	typeHandles[typeIndex] = typeHandles.back();
+	slots[typeHandles[typeIndex].slot].typeIndex = typeIndex;
+	typeHandles.pop_back();
+	slotByItem[id] = NO_SLOT;
+	slots[handle.slot].generation++;
+	freeSlots.push_back(handle.slot);
+
+	std::uint32_t last = static_cast<std::uint32_t>(stacks.size() - 1);
+	if (dense != last) {
+		stacks[dense] = stacks[last];
+		denseToSlot[dense] = denseToSlot[last];
+		slots[denseToSlot[dense]].dense = dense;
+	}
+	stacks.pop_back();
+	denseToSlot.pop_back();
+	return true;
+}
+
+const InventoryStack* Inventory::find(InventoryHandle handle) const {
+	if (handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation ||
+		denseToSlot.size() <= slots[handle.slot].dense || denseToSlot[slots[handle.slot].dense] != handle.slot) {
+		return nullptr;
+	}
+	return &stacks[slots[handle.slot].dense];
+}
+
+InventoryHandle Inventory::findItem(ItemId id) const {
+	if (id >= slotByItem.size() || slotByItem[id] == NO_SLOT) return { NO_SLOT, 0 };
+	return { slotByItem[id], slots[slotByItem[id]].generation };
+}
+
+void Inventory::clear() {
+	// Free every slot rather than forgetting them, so handles from before stay stale
+	for (std::uint32_t slot : denseToSlot) {
+		slots[slot].generation++;
+		freeSlots.push_back(slot);
+	}
+	stacks.clear();
+	denseToSlot.clear();
+	slotByItem.assign(slotByItem.size(), NO_SLOT);
+	for (auto& handles : handlesByType) handles.clear();
+}
+
+void Inventory::assign(std::span<const InventoryStack> saved) {
+	clear();
+	for (const auto& stack : saved) add(stack.catalogId, stack.count);
+}
+
+std::span<const InventoryStack> Inventory::getStacks() const { return stacks; }
+InventoryHandle Inventory::getHandle(size_t denseIndex) const {
+	std::uint32_t slot = denseToSlot[denseIndex];
+	return { slot, slots[slot].generation };
+}
+std::span<const InventoryHandle> Inventory::getHandlesByType(ItemType type) const { return handlesByType[type]; }
+size_t Inventory::size() const { return stacks.size(); }
+bool Inventory::empty() const { return stacks.empty(); }
+
+std::uint32_t Inventory::getItemCount() const {
+	std::uint32_t count = 0;
+	for (const auto& stack : stacks) count += stack.count;
+	return count;
+}
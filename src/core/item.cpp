@@ -0,0 +1,25 @@
+#include "item.h"
+
+const char* itemTypeName(ItemType type) {
+    switch (type) {
+    case ITEM_FOOD: return "Food";
+    case ITEM_MEDICINE: return "Medicine";
+    default: return "Other";
+    }
+}
+
+Item::Item(const std::string& itemName, int itemValue, ItemType itemType) :
+    name(itemName), value(itemValue), type(itemType), food{ 0, 0 } {
+}
+
+Item Item::makeFood(const std::string& foodName, int foodValue, int hungerReduc, int energyB) {
+    Item item(foodName, foodValue, ITEM_FOOD);
+    item.food = { hungerReduc, energyB };
+    return item;
+}
+
+Item Item::makeMedicine(const std::string& medName, int medValue, int healthB, int happinessR) {
+    Item item(medName, medValue, ITEM_MEDICINE);
+    item.medicine = { healthB, happinessR };
+    return item;
+}
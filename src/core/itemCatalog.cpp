@@ -0,0 +1,45 @@
+#include "itemCatalog.h"
+
+ItemCatalog::ItemCatalog() {
+	items.reserve(ITEM_COUNT);
+	build(balance());
+
+	for (size_t id = 0; id < items.size(); id++) {
+		idsByName.emplace(items[id].getName(), static_cast<ItemId>(id));
+	}
+}
+
+void ItemCatalog::build(const BalanceTable& table) {
+	for (size_t id = 0; id < ITEM_COUNT; id++) {
+		const CatalogEntry& entry = table.items[id];
+		Item item = entry.type == ITEM_MEDICINE
+			? Item::makeMedicine(entry.name, entry.price, entry.effect, entry.sideEffect)
+			: Item::makeFood(entry.name, entry.price, entry.effect, entry.sideEffect);
+		if (id < items.size()) items[id] = item;
+		else items.push_back(item);
+	}
+}
+
+ItemCatalog& ItemCatalog::instance() {
+	static ItemCatalog catalog;
+	return catalog;
+}
+
+const ItemCatalog& ItemCatalog::get() {
+	return instance();
+}
+
+void ItemCatalog::reloadBalance() {
+	instance().build(balance());
+}
+
+size_t ItemCatalog::size() const { return items.size(); }
+bool ItemCatalog::contains(ItemId id) const { return id < items.size(); }
+const Item& ItemCatalog::item(ItemId id) const { return items[id]; }
+
+bool ItemCatalog::find(const std::string& name, ItemId& id) const {
+	auto found = idsByName.find(name);
+	if (found == idsByName.end()) return false;
+	id = found->second;
+	return true;
+}
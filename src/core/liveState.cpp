@@ -0,0 +1,116 @@
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include "liveState.h"
+#include "saveFormat.h"
+#include "coreLog.h"
+
+namespace {
+
+const char LIVE_MAGIC[8] = { 'T', 'A', 'M', 'A', 'L', 'I', 'V', 'E' };
+constexpr std::uint32_t LIVE_VERSION = 1;
+
+}
+
+LivePetState::LivePetState() : layout(nullptr), readOnly(false) {}
+
+LivePetState::~LivePetState() {
+	close();
+}
+
+bool LivePetState::open(const std::string& filename) {
+	close();
+	if (!createSaveDirectory(filename) || !file.openWritable(filename, sizeof(Layout))) {
+		coreError() << "Failed to map live state file: " << filename << std::endl;
+		return false;
+	}
+	layout = reinterpret_cast<Layout*>(file.getWritableData());
+
+	if (std::memcmp(layout->magic, LIVE_MAGIC, sizeof(LIVE_MAGIC)) != 0 ||
+		layout->version != LIVE_VERSION || layout->stateSize != sizeof(PetState)) {
+		std::memset(static_cast<void*>(layout), 0, sizeof(Layout));
+		std::memcpy(layout->magic, LIVE_MAGIC, sizeof(LIVE_MAGIC));
+		layout->version = LIVE_VERSION;
+		layout->stateSize = sizeof(PetState);
+	}
+	return true;
+}
+
+bool LivePetState::openReadOnly(const std::string& filename) {
+	close();
+	if (!file.open(filename) || file.getSize() < sizeof(Layout)) {
+		file.close();
+		return false;
+	}
+	// The mapping is read-only; readOnly keeps commit() and getState() from writing to it
+	Layout* mapped = reinterpret_cast<Layout*>(const_cast<char*>(file.getData()));
+	if (std::memcmp(mapped->magic, LIVE_MAGIC, sizeof(LIVE_MAGIC)) != 0 ||
+		mapped->version != LIVE_VERSION || mapped->stateSize != sizeof(PetState)) {
+		file.close();
+		return false;
+	}
+	layout = mapped;
+	readOnly = true;
+	return true;
+}
+
+void LivePetState::close() {
+	if (layout && !readOnly) {
+		commit(true);
+	}
+	layout = nullptr;
+	readOnly = false;
+	file.close();
+}
+
+bool LivePetState::isOpen() const {
+	return layout != nullptr;
+}
+
+std::uint64_t LivePetState::slotChecksum(const Slot& slot) {
+	// Sequence and state together, so a slot with a torn sequence also fails
+	std::uint64_t sequence = slot.sequence;
+	return (static_cast<std::uint64_t>(saveChecksum(reinterpret_cast<const char*>(&slot.state), sizeof(PetState))) << 32) ^
+		saveChecksum(reinterpret_cast<const char*>(&sequence), sizeof(sequence));
+}
+
+const LivePetState::Slot* LivePetState::newestSlot() const {
+	const Slot* newest = nullptr;
+	for (const Slot& slot : layout->slots) {
+		if (slot.sequence != 0 && slot.checksum == slotChecksum(slot) &&
+			(!newest || slot.sequence > newest->sequence)) {
+			newest = &slot;
+		}
+	}
+	return newest;
+}
+
+bool LivePetState::recover(PetState& state) const {
+	if (!layout) return false;
+	const Slot* newest = newestSlot();
+	if (!newest) return false;
+	state = newest->state;
+	return true;
+}
+
+PetState* LivePetState::getState() {
+	return layout && !readOnly ? &layout->live : nullptr;
+}
+
+bool LivePetState::commit(bool wait) {
+	if (!layout || readOnly) return false;
+
+	const Slot* newest = newestSlot();
+	std::uint64_t sequence = newest ? newest->sequence + 1 : 1;
+	// Overwrite the older slot; the newest stays intact if this write is torn
+	Slot& target = layout->slots[newest == &layout->slots[0] ? 1 : 0];
+
+	target.sequence = 0;
+	std::atomic_thread_fence(std::memory_order_release);
+	target.state = layout->live;
+	target.checksum = 0;
+	target.sequence = sequence;
+	target.checksum = slotChecksum(target);
+
+	return file.sync(wait);
+}
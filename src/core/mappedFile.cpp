@@ -0,0 +1,177 @@
+#include "mappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() :
+	data(nullptr),
+	length(0),
+	writable(false),
+	fileHandle(INVALID_HANDLE_VALUE),
+	mappingHandle(nullptr) {
+}
+
+bool MappedFile::open(const std::string& filename) {
+	close();
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+	fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		close();
+		return false;
+	}
+	// Windows cannot map an empty file; treat it as an empty view
+	if (fileSize.QuadPart == 0) return true;
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		close();
+		return false;
+	}
+	mappingHandle = mapping;
+
+	data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!data) {
+		close();
+		return false;
+	}
+	length = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}
+
+bool MappedFile::openWritable(const std::string& filename, size_t size) {
+	close();
+	if (size == 0) return false;
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+		OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+	fileHandle = file;
+
+	// Mapping with an explicit size grows the file to match
+	LARGE_INTEGER mapSize;
+	mapSize.QuadPart = static_cast<LONGLONG>(size);
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, mapSize.HighPart, mapSize.LowPart, nullptr);
+	if (!mapping) {
+		close();
+		return false;
+	}
+	mappingHandle = mapping;
+
+	data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size));
+	if (!data) {
+		close();
+		return false;
+	}
+	length = size;
+	writable = true;
+	return true;
+}
+
+bool MappedFile::sync(bool wait) {
+	if (!data || !writable) return false;
+	if (!FlushViewOfFile(data, length)) return false;
+	return !wait || FlushFileBuffers(static_cast<HANDLE>(fileHandle));
+}
+
+void MappedFile::close() {
+	if (data) UnmapViewOfFile(data);
+	if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+	if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(static_cast<HANDLE>(fileHandle));
+	data = nullptr;
+	length = 0;
+	writable = false;
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile() :
+	data(nullptr),
+	length(0),
+	writable(false) {
+}
+
+bool MappedFile::open(const std::string& filename) {
+	close();
+
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		::close(fd);
+		return false;
+	}
+	// mmap rejects zero-length mappings; an empty file is just an empty view
+	if (info.st_size == 0) {
+		::close(fd);
+		return true;
+	}
+
+	void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED) return false;
+
+	data = static_cast<char*>(mapped);
+	length = static_cast<size_t>(info.st_size);
+	return true;
+}
+
+bool MappedFile::openWritable(const std::string& filename, size_t size) {
+	close();
+	if (size == 0) return false;
+
+	int fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd < 0) return false;
+	if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+		::close(fd);
+		return false;
+	}
+
+	void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED) return false;
+
+	data = static_cast<char*>(mapped);
+	length = size;
+	writable = true;
+	return true;
+}
+
+bool MappedFile::sync(bool wait) {
+	if (!data || !writable) return false;
+	return msync(data, length, wait ? MS_SYNC : MS_ASYNC) == 0;
+}
+
+void MappedFile::close() {
+	if (data) munmap(data, length);
+	data = nullptr;
+	length = 0;
+	writable = false;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+const char* MappedFile::getData() const { return data; }
+char* MappedFile::getWritableData() { return writable ? data : nullptr; }
+size_t MappedFile::getSize() const { return length; }
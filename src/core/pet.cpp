@@ -0,0 +1,446 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include "pet.h"
+#include "mappedFile.h"
+#include "saveFormat.h"
+#include "coreLog.h"
+
+Pet::Pet(const std::string& petName, const Clock& simClock) :
+	state(&ownState),
+	name(petName),
+	clock(&simClock),
+	generation(0),
+	inventoryGeneration(0) {
+	std::time_t currentTime = clock->now();
+	const BalanceTable& rules = balance();
+	state->hunger = rules.startHunger;
+	state->happiness = rules.startHappiness;
+	state->energy = rules.startEnergy;
+	state->cleanliness = rules.startCleanliness;
+	state->health = rules.startHealth;
+	state->age = 0;
+	state->isAlive = true;
+	state->lastUpdateTime = currentTime;
+	state->lastAgeTime = currentTime;
+	state->birthTime = currentTime;
+	state->criticalHungerStartTime = 0;
+	state->criticalHealthStartTime = 0;
+	state->isInCriticalHunger = false;
+	state->isInCriticalHealth = false;
+
+	// Free starter items
+	addItemToInventory(ITEM_REGULAR_FOOD);
+	addItemToInventory(ITEM_PREMIUM_FOOD);
+	addItemToInventory(ITEM_BASIC_MEDICINE);
+}
+
+Pet::~Pet() {
+	coreLog() << "Pet class destroyed." << std::endl;
+}
+
+// Save pet state to file in the binary format described in saveFormat.h
+bool Pet::savePetToFile(const std::string& filename) const {
+	return writePetSave(snapshot(), filename);
+}
+
+PetSnapshot Pet::snapshot() const {
+	PetSnapshot copy;
+	copy.state = *state;
+	copy.name = name;
+	copy.inventory.assign(inventory.getStacks().begin(), inventory.getStacks().end());
+	return copy;
+}
+
+// Legacy line-per-value text format, kept for exports and format comparisons
+bool Pet::savePetToTextFile(const std::string& filename) const {
+	if (!createSaveDirectory(filename)) return false;
+
+	std::ofstream outFile(filename);
+	if (!outFile.is_open()) {
+		coreError() << "Failed to open save file for writing" << std::endl;
+		return false;
+	}
+
+	// Write each value to the file
+	outFile << state->hunger << std::endl;
+	outFile << state->happiness << std::endl;
+	outFile << state->energy << std::endl;
+	outFile << state->cleanliness << std::endl;
+	outFile << state->health << std::endl;
+	outFile << state->age << std::endl;
+	outFile << (state->isAlive ? 1 : 0) << std::endl;
+	outFile << name << std::endl;
+	outFile << state->lastUpdateTime << std::endl;
+	outFile << state->lastAgeTime << std::endl;
+	outFile << state->birthTime << std::endl;
+	outFile << state->criticalHungerStartTime << std::endl;
+	outFile << state->criticalHealthStartTime << std::endl;
+	outFile << (state->isInCriticalHunger ? 1 : 0) << std::endl;
+	outFile << (state->isInCriticalHealth ? 1 : 0) << std::endl;
+
+	// Save inventory, one entry per item as the text format has no stacks
+	const ItemCatalog& catalog = ItemCatalog::get();
+	outFile << inventory.getItemCount() << std::endl;
+	for (const auto& stack : inventory.getStacks()) {
+		const Item& item = catalog.item(stack.catalogId);
+		int type = item.isMedicine() ? SAVE_ITEM_MEDICINE : SAVE_ITEM_FOOD;
+		for (std::uint32_t i = 0; i < stack.count; i++) {
+			outFile << item.getName() << std::endl;
+			outFile << item.getValue() << std::endl;
+			outFile << 0 << std::endl;
+			outFile << type << std::endl;
+		}
+	}
+
+	outFile.close();
+	return true;
+}
+
+bool Pet::loadPetFromFile(const std::string& filename) {
+	MappedFile file;
+	if (!file.open(filename)) {
+		coreError() << "No save file found" << std::endl;
+		return false;
+	}
+
+	// Text saves from older versions still load and are rewritten as binary on the next save
+	bool loaded = isBinarySave(file.getData(), file.getSize())
+		? readBinarySave(file.getData(), file.getSize())
+		: readTextSave(filename);
+	if (!loaded) return false;
+	generation++;
+	inventoryGeneration++;
+
+	// Catch up on everything that happened while the game was closed
+	catchUp(clock->now(), true);
+	return true;
+}
+
+bool Pet::readBinarySave(const char* data, size_t size) {
+	std::uint32_t version = SAVE_VERSION;
+	const SavePetRecord* record = viewPetSave(data, size, &version);
+	if (!record) return false;
+
+	state->hunger = littleEndian(record->hunger);
+	state->happiness = littleEndian(record->happiness);
+	state->energy = littleEndian(record->energy);
+	state->cleanliness = littleEndian(record->cleanliness);
+	state->health = littleEndian(record->health);
+	state->age = littleEndian(record->age);
+	state->isAlive = record->isAlive != 0;
+	state->lastUpdateTime = static_cast<std::time_t>(littleEndian(record->lastUpdateTime));
+	state->lastAgeTime = static_cast<std::time_t>(littleEndian(record->lastAgeTime));
+	state->birthTime = static_cast<std::time_t>(littleEndian(record->birthTime));
+	state->criticalHungerStartTime = static_cast<std::time_t>(littleEndian(record->criticalHungerStartTime));
+	state->criticalHealthStartTime = static_cast<std::time_t>(littleEndian(record->criticalHealthStartTime));
+	state->isInCriticalHunger = record->isInCriticalHunger != 0;
+	state->isInCriticalHealth = record->isInCriticalHealth != 0;
+	name.assign(data + littleEndian(record->nameOffset), littleEndian(record->nameLength));
+
+	inventory.clear();
+	const char* items = data + littleEndian(record->inventoryOffset);
+	std::uint32_t inventoryCount = littleEndian(record->inventoryCount);
+	if (version == 1) {
+		// Version 1 stored every item by name
+		const SaveItemRecordV1* itemsV1 = reinterpret_cast<const SaveItemRecordV1*>(items);
+		for (std::uint32_t i = 0; i < inventoryCount; i++) {
+			std::string itemName(data + littleEndian(itemsV1[i].nameOffset), littleEndian(itemsV1[i].nameLength));
+			addSavedItem(itemName, 1);
+		}
+		return true;
+	}
+
+	const SaveItemRecord* stacks = reinterpret_cast<const SaveItemRecord*>(items);
+	for (std::uint32_t i = 0; i < inventoryCount; i++) {
+		ItemId id = littleEndian(stacks[i].catalogId);
+		if (!ItemCatalog::get().contains(id)) {
+			coreError() << "Skipping unknown item " << id << " in save file" << std::endl;
+			continue;
+		}
+		addItemToInventory(id, littleEndian(stacks[i].count));
+	}
+	return true;
+}
+
+void Pet::addSavedItem(const std::string& itemName, std::uint32_t count) {
+	ItemId id;
+	if (!ItemCatalog::get().find(itemName, id)) {
+		coreError() << "Skipping unknown item \"" << itemName << "\" in save file" << std::endl;
+		return;
+	}
+	addItemToInventory(id, count);
+}
+
+void Pet::restore(const PetSnapshot& snapshot) {
+	*state = snapshot.state;
+	name = snapshot.name;
+	inventory.assign(snapshot.inventory);
+	generation++;
+	inventoryGeneration++;
+
+	catchUp(clock->now(), true);
+}
+
+bool Pet::readTextSave(const std::string& filename) {
+	std::ifstream inFile(filename);
+	if (!inFile.is_open()) {
+		coreError() << "No save file found" << std::endl;
+		return false;
+	}
+
+	if (!(inFile >> state->hunger) ||
+		!(inFile >> state->happiness) ||
+		!(inFile >> state->energy) ||
+		!(inFile >> state->cleanliness) ||
+		!(inFile >> state->health) ||
+		!(inFile >> state->age)) {
+		coreError() << "Error reading save file stats" << std::endl;
+		return false;
+	}
+
+	int alive;
+	if (!(inFile >> alive)) {
+		coreError() << "Error reading alive status" << std::endl;
+		return false;
+	}
+	state->isAlive = (alive != 0);
+
+	// Skip newline so getline() works correctly
+	inFile.ignore();
+
+	if (!std::getline(inFile, name)) {
+		coreError() << "Error reading pet name" << std::endl;
+		return false;
+	}
+
+	if (!(inFile >> state->lastUpdateTime) ||
+		!(inFile >> state->lastAgeTime) ||
+		!(inFile >> state->birthTime)) {
+		coreError() << "Error reading time values" << std::endl;
+		return false;
+	}
+
+	if (!(inFile >> state->criticalHungerStartTime) ||
+		!(inFile >> state->criticalHealthStartTime)) {
+		coreError() << "Error reading critical condition times" << std::endl;
+		state->criticalHungerStartTime = 0;
+		state->criticalHealthStartTime = 0;
+		state->isInCriticalHunger = false;
+		state->isInCriticalHealth = false;
+	}
+	else {
+		int criticalHunger, criticalHealth;
+		if (!(inFile >> criticalHunger) ||
+			!(inFile >> criticalHealth)) {
+			coreError() << "Error reading critical condition flags" << std::endl;
+			state->isInCriticalHunger = false;
+			state->isInCriticalHealth = false;
+		}
+		else {
+			state->isInCriticalHunger = (criticalHunger != 0);
+			state->isInCriticalHealth = (criticalHealth != 0);
+		}
+	}
+
+	// Clear existing inventory
+	inventory.clear();
+
+	int inventorySize;
+	if (!(inFile >> inventorySize)) {
+		coreError() << "Error reading inventory size, using default items" << std::endl;
+		// Add default items
+		addItemToInventory(ITEM_REGULAR_FOOD);
+	}
+	else {
+		inFile.ignore();
+
+		for (int i = 0; i < inventorySize; i++) {
+			std::string itemName;
+			int itemValue, consumedFlag, itemType;
+
+			if (!std::getline(inFile, itemName) ||
+				!(inFile >> itemValue) ||
+				!(inFile >> consumedFlag) ||
+				!(inFile >> itemType)) {
+				coreError() << "Error reading inventory item " << i << std::endl;
+				continue;
+			}
+			inFile.ignore();
+
+			// Value, flag and type now come from the catalog
+			addSavedItem(itemName, 1);
+		}
+	}
+
+	return true;
+}
+
+void Pet::update() {
+	catchUp(clock->now(), false);
+}
+
+void Pet::update(std::time_t currentTime) {
+	catchUp(currentTime, false);
+}
+
+FastForwardResult Pet::advanceTo(std::time_t currentTime) {
+	FastForwardResult result = fastForward(*state, currentTime);
+	if (!(result.state == *state)) {
+		*state = result.state;
+		generation++;
+	}
+	return result;
+}
+
+PetEvent Pet::nextEvent() const {
+	return nextPetEvent(*state);
+}
+
+void Pet::catchUp(std::time_t currentTime, bool whileAway) {
+	if (!state->isAlive) return;
+
+	FastForwardResult result = advanceTo(currentTime);
+
+	if (whileAway) {
+		if (result.daysAged > 0) {
+			coreLog() << "Pet aged " << result.daysAged << " days while you were away" << std::endl;
+		}
+		if (result.deathCause == DEATH_STARVATION) {
+			coreLog() << "Your pet died of starvation while you were away" << std::endl;
+		}
+		else if (result.deathCause == DEATH_ILLNESS) {
+			coreLog() << "Your pet died of illness while you were away" << std::endl;
+		}
+		return;
+	}
+
+	if (result.hungerCriticalTime) {
+		coreLog() << "Pet is critically hungry!" << std::endl;
+	}
+	if (result.healthCriticalTime) {
+		coreLog() << "Pet is critically sick!" << std::endl;
+	}
+	if (result.deathCause == DEATH_STARVATION) {
+		coreLog() << "Your pet died of starvation after " << balance().deathConditionHours << " hours without food" << std::endl;
+	}
+	else if (result.deathCause == DEATH_ILLNESS) {
+		coreLog() << "Your pet died of illness after " << balance().deathConditionHours << " hours of being sick" << std::endl;
+	}
+	else if (result.daysAged > 0) {
+		coreLog() << "Pet aged to " << state->age << " days" << std::endl;
+	}
+}
+
+void Pet::feed(int amount) {
+	if (state->isAlive) {
+		generation++;
+		state->hunger = std::max(0, state->hunger - amount);
+
+		if (state->isInCriticalHunger) {
+			state->isInCriticalHunger = false;
+			state->criticalHungerStartTime = 0;
+			coreLog() << "Pet is no longer critically hungry" << std::endl;
+		}
+	}
+}
+
+void Pet::play() {
+	const BalanceTable& rules = balance();
+	if (state->isAlive && state->energy > rules.playMinEnergy) {
+		generation++;
+		state->happiness = std::min(100, state->happiness + rules.playHappiness);
+		state->energy = std::max(0, state->energy - rules.playEnergyCost);
+		state->hunger = std::min(100, state->hunger + rules.playHunger);
+	}
+}
+
+void Pet::sleep() {
+	if (state->isAlive) {
+		generation++;
+		state->energy = std::min(100, state->energy + balance().sleepEnergy);
+		state->hunger = std::min(100, state->hunger + balance().sleepHunger);
+	}
+}
+
+void Pet::clean() {
+	if (state->isAlive) {
+		generation++;
+		state->cleanliness = 100;
+		state->happiness = std::min(100, state->happiness + balance().cleanHappiness);
+	}
+}
+
+void Pet::medicine(int amount) {
+	if (state->isAlive) {
+		generation++;
+		state->health = std::min(100, state->health + amount);
+
+		// Reset critical health condition once health is above the critical level
+		if (state->health > balance().criticalHealth && state->isInCriticalHealth) {
+			state->isInCriticalHealth = false;
+			state->criticalHealthStartTime = 0;
+			coreLog() << "Pet is no longer critically sick" << std::endl;
+		}
+	}
+}
+
+bool Pet::addItemToInventory(ItemId id, std::uint32_t count) {
+	if (count == 0 || !inventory.add(id, count)) return false;
+
+	generation++;
+	inventoryGeneration++;
+	return true;
+}
+
+bool Pet::useItemFromInventory(InventoryHandle handle) {
+	const InventoryStack* stack = inventory.find(handle);
+	if (!stack) return false;
+
+	ItemCatalog::get().item(stack->catalogId).use(this);
+	inventory.take(handle);
+	generation++;
+	inventoryGeneration++;
+	return true;
+}
+
+const Inventory& Pet::getInventory() const {
+	return inventory;
+}
+
+int Pet::getHunger() const { return state->hunger; }
+int Pet::getHappiness() const { return state->happiness; }
+int Pet::getEnergy() const { return state->energy; }
+int Pet::getCleanliness() const { return state->cleanliness; }
+int Pet::getHealth() const { return state->health; }
+int Pet::getAge() const { return state->age; }
+bool Pet::getIsAlive() const { return state->isAlive; }
+std::string Pet::getName() const { return name; }
+const PetState& Pet::getState() const { return *state; }
+void Pet::setState(const PetState& newState) {
+	*state = newState;
+	generation++;
+}
+std::uint64_t Pet::getGeneration() const { return generation; }
+std::uint64_t Pet::getInventoryGeneration() const { return inventoryGeneration; }
+
+void Pet::attachState(PetState* external) {
+	PetState* target = external ? external : &ownState;
+	if (target != state) {
+		*target = *state;
+		state = target;
+	}
+}
+
+std::string Pet::getMood() const {
+	const BalanceTable& rules = balance();
+	if (!state->isAlive) return "Dead";
+	if (state->hunger > rules.moodHungryAbove) return "Hungry";
+	if (state->energy < rules.moodTiredBelow) return "Tired";
+	if (state->cleanliness < rules.moodDirtyBelow) return "Dirty";
+	if (state->health < rules.moodSickBelow) return "Sick";
+	if (state->happiness < rules.moodSadBelow) return "Sad";
+	if (state->happiness > rules.moodHappyAbove) return "Happy";
+	return "Normal";
+}
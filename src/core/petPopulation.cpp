@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <cstring>
+#include "petPopulation.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TAMA_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define TAMA_X86 0
+#endif
+
+// GCC/Clang need the instruction set enabled per function; MSVC always accepts the intrinsics
+#if TAMA_X86 && (defined(__GNUC__) || defined(__clang__))
+#define TAMA_TARGET(isa) __attribute__((target(isa)))
+#else
+#define TAMA_TARGET(isa)
+#endif
+
+namespace {
+
+struct DecayColumns {
+	std::int32_t* hunger;
+	std::int32_t* happiness;
+	std::int32_t* energy;
+	std::int32_t* cleanliness;
+	std::int32_t* health;
+	const std::uint8_t* alive;
+};
+
+// Reference kernel; the SIMD kernels must match it bit for bit
+void decayScalar(const DecayColumns& c, size_t begin, size_t end, int minutes) {
+	const int hungerGain = minutes * balance().hungerPerMinute;
+	const int happinessLoss = minutes * balance().happinessDecayPerMinute;
+	const int energyLoss = minutes * balance().energyDecayPerMinute;
+	const int cleanlinessLoss = minutes * balance().cleanlinessDecayPerMinute;
+
+	for (size_t i = begin; i < end; i++) {
+		if (!c.alive[i]) continue;
+
+		int h = std::min(100, std::max(0, c.hunger[i] + hungerGain));
+		int hp = std::min(100, std::max(0, c.happiness[i] - happinessLoss));
+		int en = std::min(100, std::max(0, c.energy[i] - energyLoss));
+		int cl = std::min(100, std::max(0, c.cleanliness[i] - cleanlinessLoss));
+
+		c.hunger[i] = h;
+		c.happiness[i] = hp;
+		c.energy[i] = en;
+		c.cleanliness[i] = cl;
+		c.health[i] = 100 - ((h + (100 - hp) + (100 - en) + (100 - cl)) / 4);
+	}
+}
+
+#if TAMA_X86
+TAMA_TARGET("sse4.1")
+void decaySse41(const DecayColumns& c, size_t begin, size_t end, int minutes) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i hundred = _mm_set1_epi32(100);
+	const __m128i threeHundred = _mm_set1_epi32(300);
+	const __m128i hungerGain = _mm_set1_epi32(minutes * balance().hungerPerMinute);
+	const __m128i happinessLoss = _mm_set1_epi32(minutes * balance().happinessDecayPerMinute);
+	const __m128i energyLoss = _mm_set1_epi32(minutes * balance().energyDecayPerMinute);
+	const __m128i cleanlinessLoss = _mm_set1_epi32(minutes * balance().cleanlinessDecayPerMinute);
+
+	size_t i = begin;
+	for (; i + 4 <= end; i += 4) {
+		std::int32_t aliveBytes;
+		std::memcpy(&aliveBytes, c.alive + i, sizeof(aliveBytes));
+		__m128i mask = _mm_cmpgt_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(aliveBytes)), zero);
+
+		__m128i h0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.hunger + i));
+		__m128i hp0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.happiness + i));
+		__m128i en0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.energy + i));
+		__m128i cl0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.cleanliness + i));
+		__m128i he0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.health + i));
+
+		__m128i h = _mm_min_epi32(hundred, _mm_max_epi32(zero, _mm_add_epi32(h0, hungerGain)));
+		__m128i hp = _mm_min_epi32(hundred, _mm_max_epi32(zero, _mm_sub_epi32(hp0, happinessLoss)));
+		__m128i en = _mm_min_epi32(hundred, _mm_max_epi32(zero, _mm_sub_epi32(en0, energyLoss)));
+		__m128i cl = _mm_min_epi32(hundred, _mm_max_epi32(zero, _mm_sub_epi32(cl0, cleanlinessLoss)));
+
+		// The sum is never negative, so the shift matches the scalar division by 4
+		__m128i sum = _mm_sub_epi32(_mm_add_epi32(h, threeHundred), _mm_add_epi32(hp, _mm_add_epi32(en, cl)));
+		__m128i he = _mm_sub_epi32(hundred, _mm_srai_epi32(sum, 2));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(c.hunger + i), _mm_blendv_epi8(h0, h, mask));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(c.happiness + i), _mm_blendv_epi8(hp0, hp, mask));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(c.energy + i), _mm_blendv_epi8(en0, en, mask));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(c.cleanliness + i), _mm_blendv_epi8(cl0, cl, mask));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(c.health + i), _mm_blendv_epi8(he0, he, mask));
+	}
+
+	decayScalar(c, i, end, minutes);
+}
+
+TAMA_TARGET("avx2")
+void decayAvx2(const DecayColumns& c, size_t begin, size_t end, int minutes) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i hundred = _mm256_set1_epi32(100);
+	const __m256i threeHundred = _mm256_set1_epi32(300);
+	const __m256i hungerGain = _mm256_set1_epi32(minutes * balance().hungerPerMinute);
+	const __m256i happinessLoss = _mm256_set1_epi32(minutes * balance().happinessDecayPerMinute);
+	const __m256i energyLoss = _mm256_set1_epi32(minutes * balance().energyDecayPerMinute);
+	const __m256i cleanlinessLoss = _mm256_set1_epi32(minutes * balance().cleanlinessDecayPerMinute);
+
+	size_t i = begin;
+	for (; i + 8 <= end; i += 8) {
+		__m128i aliveBytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(c.alive + i));
+		__m256i mask = _mm256_cmpgt_epi32(_mm256_cvtepu8_epi32(aliveBytes), zero);
+
+		__m256i h0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.hunger + i));
+		__m256i hp0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.happiness + i));
+		__m256i en0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.energy + i));
+		__m256i cl0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.cleanliness + i));
+		__m256i he0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.health + i));
+
+		__m256i h = _mm256_min_epi32(hundred, _mm256_max_epi32(zero, _mm256_add_epi32(h0, hungerGain)));
+		__m256i hp = _mm256_min_epi32(hundred, _mm256_max_epi32(zero, _mm256_sub_epi32(hp0, happinessLoss)));
+		__m256i en = _mm256_min_epi32(hundred, _mm256_max_epi32(zero, _mm256_sub_epi32(en0, energyLoss)));
+		__m256i cl = _mm256_min_epi32(hundred, _mm256_max_epi32(zero, _mm256_sub_epi32(cl0, cleanlinessLoss)));
+
+		__m256i sum = _mm256_sub_epi32(_mm256_add_epi32(h, threeHundred), _mm256_add_epi32(hp, _mm256_add_epi32(en, cl)));
+		__m256i he = _mm256_sub_epi32(hundred, _mm256_srai_epi32(sum, 2));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(c.hunger + i), _mm256_blendv_epi8(h0, h, mask));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(c.happiness + i), _mm256_blendv_epi8(hp0, hp, mask));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(c.energy + i), _mm256_blendv_epi8(en0, en, mask));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(c.cleanliness + i), _mm256_blendv_epi8(cl0, cl, mask));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(c.health + i), _mm256_blendv_epi8(he0, he, mask));
+	}
+
+	decayScalar(c, i, end, minutes);
+}
+
+DecayKernel detectKernel() {
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	bool sse41 = (info[2] & (1 << 19)) != 0;
+	bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+	__cpuidex(info, 7, 0);
+	bool avx2 = osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	bool sse41 = __builtin_cpu_supports("sse4.1");
+	bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+	if (avx2) return DECAY_AVX2;
+	if (sse41) return DECAY_SSE41;
+	return DECAY_SCALAR;
+}
+#endif
+
+}
+
+void PetPopulation::reserve(size_t count) {
+	hunger.reserve(count);
+	happiness.reserve(count);
+	energy.reserve(count);
+	cleanliness.reserve(count);
+	health.reserve(count);
+	alive.reserve(count);
+}
+
+size_t PetPopulation::size() const {
+	return hunger.size();
+}
+
+size_t PetPopulation::addPet(const Pet& pet) {
+	return addPet(pet.getHunger(), pet.getHappiness(), pet.getEnergy(),
+		pet.getCleanliness(), pet.getHealth(), pet.getIsAlive());
+}
+
+size_t PetPopulation::addPet(int petHunger, int petHappiness, int petEnergy, int petCleanliness, int petHealth, bool isAlive) {
+	hunger.push_back(petHunger);
+	happiness.push_back(petHappiness);
+	energy.push_back(petEnergy);
+	cleanliness.push_back(petCleanliness);
+	health.push_back(petHealth);
+	alive.push_back(isAlive ? 1 : 0);
+	return hunger.size() - 1;
+}
+
+void PetPopulation::decay(int minutes) {
+	static const DecayKernel kernel = bestKernel();
+	decay(minutes, kernel);
+}
+
+size_t PetPopulation::getShardCount() const {
+	return (size() + SHARD_SIZE - 1) / SHARD_SIZE;
+}
+
+void PetPopulation::decay(int minutes, ThreadPool& pool) {
+	static const DecayKernel kernel = bestKernel();
+	pool.parallelFor(getShardCount(), [&](size_t shard) {
+		decayRange(shard * SHARD_SIZE, (shard + 1) * SHARD_SIZE, minutes, kernel);
+	});
+}
+
+void PetPopulation::decayTicks(int ticks, int minutes, ThreadPool& pool) {
+	static const DecayKernel kernel = bestKernel();
+	pool.parallelFor(getShardCount(), [&](size_t shard) {
+		for (int t = 0; t < ticks; t++) {
+			decayRange(shard * SHARD_SIZE, (shard + 1) * SHARD_SIZE, minutes, kernel);
+		}
+	});
+}
+
+void PetPopulation::decay(int minutes, DecayKernel kernel) {
+	decayRange(0, size(), minutes, kernel);
+}
+
+void PetPopulation::decayRange(size_t begin, size_t end, int minutes, DecayKernel kernel) {
+	if (minutes <= 0) return;
+	minutes = std::min(minutes, MAX_DECAY_MINUTES);
+	end = std::min(end, size());
+	if (begin >= end) return;
+
+	DecayColumns columns = { hunger.data(), happiness.data(), energy.data(),
+		cleanliness.data(), health.data(), alive.data() };
+
+	switch (kernel) {
+#if TAMA_X86
+	case DECAY_AVX2:
+		decayAvx2(columns, begin, end, minutes);
+		break;
+	case DECAY_SSE41:
+		decaySse41(columns, begin, end, minutes);
+		break;
+#endif
+	default:
+		decayScalar(columns, begin, end, minutes);
+		break;
+	}
+}
+
+DecayKernel PetPopulation::bestKernel() {
+#if TAMA_X86
+	return detectKernel();
+#else
+	return DECAY_SCALAR;
+#endif
+}
+
+const char* PetPopulation::kernelName(DecayKernel kernel) {
+	switch (kernel) {
+	case DECAY_AVX2: return "AVX2";
+	case DECAY_SSE41: return "SSE4.1";
+	default: return "Scalar";
+	}
+}
+
+int PetPopulation::getHunger(size_t index) const { return hunger[index]; }
+int PetPopulation::getHappiness(size_t index) const { return happiness[index]; }
+int PetPopulation::getEnergy(size_t index) const { return energy[index]; }
+int PetPopulation::getCleanliness(size_t index) const { return cleanliness[index]; }
+int PetPopulation::getHealth(size_t index) const { return health[index]; }
+bool PetPopulation::getIsAlive(size_t index) const { return alive[index] != 0; }
+void PetPopulation::setIsAlive(size_t index, bool isAlive) { alive[index] = isAlive ? 1 : 0; }
@@ -0,0 +1,83 @@
+#include "petScheduler.h"
+
+namespace {
+
+std::uint64_t makeTimerId(size_t id, std::uint32_t generation) {
+	return (static_cast<std::uint64_t>(generation) << 32) | static_cast<std::uint32_t>(id);
+}
+
+}
+
+PetScheduler::PetScheduler(std::time_t start) :
+	wheel(start),
+	eventCounts{} {
+}
+
+size_t PetScheduler::addPet(Pet* pet) {
+	size_t id;
+	if (!freeIds.empty()) {
+		id = freeIds.back();
+		freeIds.pop_back();
+		pets[id] = pet;
+	}
+	else {
+		id = pets.size();
+		pets.push_back(pet);
+		generations.push_back(0);
+	}
+	reschedule(id);
+	return id;
+}
+
+void PetScheduler::removePet(size_t id) {
+	if (id >= pets.size() || !pets[id]) return;
+	pets[id] = nullptr;
+	generations[id]++;
+	freeIds.push_back(id);
+}
+
+void PetScheduler::reschedule(size_t id) {
+	if (id >= pets.size() || !pets[id]) return;
+	generations[id]++;
+	schedule(id, wheel.getCurrentTime());
+}
+
+void PetScheduler::schedule(size_t id, std::time_t now) {
+	PetEvent next = pets[id]->nextEvent();
+	if (next.kind == PET_EVENT_NONE) return;
+
+	wheel.schedule(next.time < now ? now : next.time, makeTimerId(id, generations[id]));
+}
+
+size_t PetScheduler::advanceTo(std::time_t now) {
+	expired.clear();
+	wheel.advance(now, expired);
+
+	size_t updated = 0;
+	for (const TimerEntry& timer : expired) {
+		size_t id = static_cast<std::uint32_t>(timer.id);
+		std::uint32_t generation = static_cast<std::uint32_t>(timer.id >> 32);
+		if (id >= pets.size() || !pets[id] || generations[id] != generation) continue;
+
+		Pet* pet = pets[id];
+		eventCounts[pet->nextEvent().kind]++;
+		pet->update(now);
+		updated++;
+
+		// An update at `now` settles everything due, so the next event is in the future
+		schedule(id, now + 1);
+	}
+	return updated;
+}
+
+std::time_t PetScheduler::nextDueTime() const {
+	return wheel.nextExpiry();
+}
+
+size_t PetScheduler::getEventCount(PetEventKind kind) const {
+	return eventCounts[kind];
+}
+
+size_t PetScheduler::getScheduledCount() const {
+	return wheel.size();
+}
@@ -0,0 +1,482 @@
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include "petStore.h"
+#include "coreLog.h"
+
+namespace {
+
+const char STORE_MAGIC[8] = { 'T', 'A', 'M', 'A', 'S', 'T', 'O', 'R' };
+constexpr std::uint32_t STORE_VERSION = 2;
+constexpr std::uint32_t MIN_BLOCK_SIZE = 32;
+constexpr std::uint32_t BLOCK_CLASSES = 32;
+
+std::uint64_t hashName(const std::string& name) {
+	std::uint64_t hash = 14695981039346656037ull;
+	for (char c : name) {
+		hash ^= static_cast<std::uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+std::uint32_t blockClassFor(size_t bytes) {
+	std::uint32_t sizeClass = 0;
+	while ((static_cast<std::uint64_t>(MIN_BLOCK_SIZE) << sizeClass) < bytes) sizeClass++;
+	return sizeClass;
+}
+
+std::uint64_t blockSize(std::uint32_t sizeClass) {
+	return static_cast<std::uint64_t>(MIN_BLOCK_SIZE) << sizeClass;
+}
+
+// Byte order conversion is its own inverse, so the same function serves reads and writes
+StoreHeader headerByteOrder(StoreHeader h) {
+	h.version = littleEndian(h.version);
+	h.petCount = littleEndian(h.petCount);
+	h.bucketOffset = littleEndian(h.bucketOffset);
+	h.bucketCount = littleEndian(h.bucketCount);
+	h.fileEnd = littleEndian(h.fileEnd);
+	h.freeRecords = littleEndian(h.freeRecords);
+	for (std::uint64_t& head : h.freeBlocks) head = littleEndian(head);
+	return h;
+}
+
+StoreRecord recordByteOrder(StoreRecord r) {
+	r.nameHash = littleEndian(r.nameHash);
+	r.next = littleEndian(r.next);
+	r.heapOffset = littleEndian(r.heapOffset);
+	r.heapLength = littleEndian(r.heapLength);
+	r.heapClass = littleEndian(r.heapClass);
+	r.nameLength = littleEndian(r.nameLength);
+	r.lastUpdateTime = littleEndian(r.lastUpdateTime);
+	r.lastAgeTime = littleEndian(r.lastAgeTime);
+	r.birthTime = littleEndian(r.birthTime);
+	r.criticalHungerStartTime = littleEndian(r.criticalHungerStartTime);
+	r.criticalHealthStartTime = littleEndian(r.criticalHealthStartTime);
+	r.hunger = littleEndian(r.hunger);
+	r.happiness = littleEndian(r.happiness);
+	r.energy = littleEndian(r.energy);
+	r.cleanliness = littleEndian(r.cleanliness);
+	r.health = littleEndian(r.health);
+	r.age = littleEndian(r.age);
+	return r;
+}
+
+void copyStateToRecord(const PetState& state, StoreRecord& record) {
+	record.lastUpdateTime = state.lastUpdateTime;
+	record.lastAgeTime = state.lastAgeTime;
+	record.birthTime = state.birthTime;
+	record.criticalHungerStartTime = state.criticalHungerStartTime;
+	record.criticalHealthStartTime = state.criticalHealthStartTime;
+	record.hunger = state.hunger;
+	record.happiness = state.happiness;
+	record.energy = state.energy;
+	record.cleanliness = state.cleanliness;
+	record.health = state.health;
+	record.age = state.age;
+	record.isAlive = state.isAlive ? 1 : 0;
+	record.isInCriticalHunger = state.isInCriticalHunger ? 1 : 0;
+	record.isInCriticalHealth = state.isInCriticalHealth ? 1 : 0;
+}
+
+void copyRecordToState(const StoreRecord& record, PetState& state) {
+	state.lastUpdateTime = static_cast<std::time_t>(record.lastUpdateTime);
+	state.lastAgeTime = static_cast<std::time_t>(record.lastAgeTime);
+	state.birthTime = static_cast<std::time_t>(record.birthTime);
+	state.criticalHungerStartTime = static_cast<std::time_t>(record.criticalHungerStartTime);
+	state.criticalHealthStartTime = static_cast<std::time_t>(record.criticalHealthStartTime);
+	state.hunger = record.hunger;
+	state.happiness = record.happiness;
+	state.energy = record.energy;
+	state.cleanliness = record.cleanliness;
+	state.health = record.health;
+	state.age = record.age;
+	state.isAlive = record.isAlive != 0;
+	state.isInCriticalHunger = record.isInCriticalHunger != 0;
+	state.isInCriticalHealth = record.isInCriticalHealth != 0;
+}
+
+template <typename T>
+void appendValue(std::string& buffer, T value) {
+	value = littleEndian(value);
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool takeValue(const std::string& buffer, size_t& position, T& value) {
+	if (buffer.size() - position < sizeof(T)) return false;
+	std::memcpy(&value, buffer.data() + position, sizeof(T));
+	value = littleEndian(value);
+	position += sizeof(T);
+	return true;
+}
+
+// Heap block: name bytes, stack count, then per stack the catalog ID and item count
+std::string encodeHeapBlock(const PetSnapshot& snapshot) {
+	std::string block = snapshot.name;
+	appendValue<std::uint32_t>(block, static_cast<std::uint32_t>(snapshot.inventory.size()));
+	for (const auto& stack : snapshot.inventory) {
+		appendValue<std::uint16_t>(block, stack.catalogId);
+		appendValue<std::uint32_t>(block, stack.count);
+	}
+	return block;
+}
+
+bool decodeInventory(const std::string& block, size_t position, std::vector<InventoryStack>& inventory) {
+	std::uint32_t count;
+	if (!takeValue(block, position, count)) return false;
+
+	inventory.clear();
+	inventory.reserve(count);
+	for (std::uint32_t i = 0; i < count; i++) {
+		InventoryStack stack;
+		if (!takeValue(block, position, stack.catalogId) ||
+			!takeValue(block, position, stack.count) ||
+			!ItemCatalog::get().contains(stack.catalogId)) {
+			return false;
+		}
+		inventory.push_back(stack);
+	}
+	return true;
+}
+
+}
+
+PetStore::PetStore() : header{} {}
+
+PetStore::~PetStore() {
+	close();
+}
+
+bool PetStore::open(const std::string& filename, size_t expectedPets) {
+	close();
+	path = filename;
+
+	if (!std::filesystem::exists(filename)) {
+		if (!createSaveDirectory(filename)) return false;
+		std::ofstream create(filename, std::ios::binary | std::ios::trunc);
+		if (!create.is_open()) {
+			coreError() << "Failed to create pet store: " << filename << std::endl;
+			return false;
+		}
+		create.close();
+
+		file.open(filename, std::ios::in | std::ios::out | std::ios::binary);
+		std::uint64_t buckets = 64;
+		while (buckets < expectedPets) buckets <<= 1;
+
+		header = {};
+		std::memcpy(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+		header.version = STORE_VERSION;
+		header.bucketOffset = sizeof(StoreHeader);
+		header.bucketCount = buckets;
+		header.fileEnd = header.bucketOffset + buckets * sizeof(std::uint64_t);
+
+		std::vector<std::uint64_t> emptyBuckets(buckets, 0);
+		if (!writeHeader() ||
+			!writeAt(header.bucketOffset, emptyBuckets.data(), emptyBuckets.size() * sizeof(std::uint64_t))) {
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	file.open(filename, std::ios::in | std::ios::out | std::ios::binary);
+	StoreHeader stored;
+	if (!file.is_open() || !readAt(0, &stored, sizeof(stored))) {
+		coreError() << "Failed to open pet store: " << filename << std::endl;
+		close();
+		return false;
+	}
+	header = headerByteOrder(stored);
+	if (std::memcmp(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0 || header.version != STORE_VERSION) {
+		coreError() << "Not a pet store: " << filename << std::endl;
+		close();
+		return false;
+	}
+	return true;
+}
+
+void PetStore::close() {
+	if (file.is_open()) {
+		file.flush();
+		file.close();
+	}
+}
+
+bool PetStore::isOpen() const {
+	return file.is_open();
+}
+
+size_t PetStore::size() const {
+	return static_cast<size_t>(header.petCount);
+}
+
+bool PetStore::readAt(std::uint64_t offset, void* data, size_t size) {
+	file.clear();
+	file.seekg(static_cast<std::streamoff>(offset));
+	return static_cast<bool>(file.read(static_cast<char*>(data), static_cast<std::streamsize>(size)));
+}
+
+bool PetStore::writeAt(std::uint64_t offset, const void* data, size_t size) {
+	file.clear();
+	file.seekp(static_cast<std::streamoff>(offset));
+	if (!file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size))) {
+		coreError() << "Failed to write pet store" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool PetStore::readRecord(std::uint64_t offset, StoreRecord& record) {
+	if (!readAt(offset, &record, sizeof(record))) return false;
+	record = recordByteOrder(record);
+	return true;
+}
+
+bool PetStore::writeRecord(std::uint64_t offset, const StoreRecord& record) {
+	StoreRecord stored = recordByteOrder(record);
+	return writeAt(offset, &stored, sizeof(stored));
+}
+
+bool PetStore::writeHeader() {
+	StoreHeader stored = headerByteOrder(header);
+	return writeAt(0, &stored, sizeof(stored));
+}
+
+std::uint64_t PetStore::bucketSlot(std::uint64_t hash) const {
+	return header.bucketOffset + (hash & (header.bucketCount - 1)) * sizeof(std::uint64_t);
+}
+
+bool PetStore::readName(const StoreRecord& record, std::string& name) {
+	name.resize(record.nameLength);
+	return record.nameLength == 0 || readAt(record.heapOffset, name.data(), record.nameLength);
+}
+
+bool PetStore::findRecord(const std::string& name, std::uint64_t& offset, StoreRecord& record, std::uint64_t* previous) {
+	if (!file.is_open()) return false;
+
+	std::uint64_t hash = hashName(name);
+	std::uint64_t link = 0;
+	if (!readAt(bucketSlot(hash), &offset, sizeof(offset))) return false;
+	offset = littleEndian(offset);
+
+	std::string storedName;
+	while (offset != 0) {
+		if (!readRecord(offset, record)) return false;
+		// Names are only read from the heap when the full hash matches
+		if (record.nameHash == hash && record.nameLength == name.size() &&
+			readName(record, storedName) && storedName == name) {
+			if (previous) *previous = link;
+			return true;
+		}
+		link = offset;
+		offset = record.next;
+	}
+	return false;
+}
+
+std::uint64_t PetStore::allocateRecord() {
+	if (header.freeRecords != 0) {
+		std::uint64_t offset = header.freeRecords;
+		StoreRecord freeRecord;
+		if (!readRecord(offset, freeRecord)) return 0;
+		header.freeRecords = freeRecord.next;
+		return offset;
+	}
+	std::uint64_t offset = header.fileEnd;
+	header.fileEnd += sizeof(StoreRecord);
+	return offset;
+}
+
+std::uint64_t PetStore::allocateBlock(std::uint32_t sizeClass) {
+	if (header.freeBlocks[sizeClass] != 0) {
+		std::uint64_t offset = header.freeBlocks[sizeClass];
+		std::uint64_t next;
+		if (!readAt(offset, &next, sizeof(next))) return 0;
+		header.freeBlocks[sizeClass] = littleEndian(next);
+		return offset;
+	}
+	std::uint64_t offset = header.fileEnd;
+	header.fileEnd += blockSize(sizeClass);
+	return offset;
+}
+
+void PetStore::freeBlock(std::uint64_t offset, std::uint32_t sizeClass) {
+	std::uint64_t next = littleEndian(header.freeBlocks[sizeClass]);
+	if (writeAt(offset, &next, sizeof(next))) {
+		header.freeBlocks[sizeClass] = offset;
+	}
+}
+
+// Doubles the bucket array once the average chain is longer than one record
+bool PetStore::growBuckets() {
+	std::vector<std::uint64_t> oldBuckets(header.bucketCount);
+	if (!readAt(header.bucketOffset, oldBuckets.data(), oldBuckets.size() * sizeof(std::uint64_t))) return false;
+
+	std::uint64_t newCount = header.bucketCount * 2;
+	std::uint32_t newClass = blockClassFor(newCount * sizeof(std::uint64_t));
+	std::uint64_t newOffset = allocateBlock(newClass);
+	if (newOffset == 0) return false;
+
+	std::vector<std::uint64_t> newBuckets(newCount, 0);
+	for (std::uint64_t head : oldBuckets) {
+		std::uint64_t offset = littleEndian(head);
+		while (offset != 0) {
+			StoreRecord record;
+			if (!readRecord(offset, record)) return false;
+			std::uint64_t next = record.next;
+			std::uint64_t& slot = newBuckets[record.nameHash & (newCount - 1)];
+			record.next = littleEndian(slot);
+			if (!writeRecord(offset, record)) return false;
+			slot = littleEndian(offset);
+			offset = next;
+		}
+	}
+	if (!writeAt(newOffset, newBuckets.data(), newBuckets.size() * sizeof(std::uint64_t))) return false;
+
+	// The initial array sits right after the header and is not a heap block, so only later
+	// arrays can be recycled
+	if (header.bucketOffset != sizeof(StoreHeader)) {
+		freeBlock(header.bucketOffset, blockClassFor(header.bucketCount * sizeof(std::uint64_t)));
+	}
+	header.bucketOffset = newOffset;
+	header.bucketCount = newCount;
+	return writeHeader();
+}
+
+bool PetStore::contains(const std::string& name) {
+	std::uint64_t offset;
+	StoreRecord record;
+	return findRecord(name, offset, record);
+}
+
+bool PetStore::put(const PetSnapshot& snapshot) {
+	if (!file.is_open()) return false;
+
+	std::string block = encodeHeapBlock(snapshot);
+	std::uint32_t sizeClass = blockClassFor(block.size());
+	if (sizeClass >= BLOCK_CLASSES) {
+		coreError() << "Pet too large for the store: " << snapshot.name << std::endl;
+		return false;
+	}
+
+	std::uint64_t offset;
+	StoreRecord record;
+	bool exists = findRecord(snapshot.name, offset, record);
+	if (!exists) {
+		offset = allocateRecord();
+		if (offset == 0) return false;
+		record = {};
+		record.nameHash = hashName(snapshot.name);
+		record.nameLength = static_cast<std::uint32_t>(snapshot.name.size());
+	}
+
+	// Keep the heap block if the new contents still fit its size class
+	if (!exists || record.heapClass != sizeClass) {
+		if (exists) freeBlock(record.heapOffset, record.heapClass);
+		record.heapOffset = allocateBlock(sizeClass);
+		record.heapClass = sizeClass;
+		if (record.heapOffset == 0) return false;
+	}
+	record.heapLength = static_cast<std::uint32_t>(block.size());
+	copyStateToRecord(snapshot.state, record);
+
+	if (!writeAt(record.heapOffset, block.data(), block.size())) return false;
+
+	if (!exists) {
+		std::uint64_t slot = bucketSlot(record.nameHash);
+		std::uint64_t head;
+		if (!readAt(slot, &head, sizeof(head))) return false;
+		record.next = littleEndian(head);
+		std::uint64_t newHead = littleEndian(offset);
+		if (!writeRecord(offset, record) || !writeAt(slot, &newHead, sizeof(newHead))) return false;
+
+		header.petCount++;
+		if (header.petCount > header.bucketCount) {
+			return growBuckets();
+		}
+		return writeHeader();
+	}
+	return writeRecord(offset, record) && writeHeader();
+}
+
+bool PetStore::load(const std::string& name, PetSnapshot& snapshot) {
+	std::uint64_t offset;
+	StoreRecord record;
+	if (!findRecord(name, offset, record)) return false;
+
+	std::string block(record.heapLength, '\0');
+	if (!readAt(record.heapOffset, block.data(), block.size()) ||
+		!decodeInventory(block, record.nameLength, snapshot.inventory)) {
+		coreError() << "Damaged pet store entry: " << name << std::endl;
+		return false;
+	}
+	snapshot.name = name;
+	copyRecordToState(record, snapshot.state);
+	return true;
+}
+
+bool PetStore::loadState(const std::string& name, PetState& state) {
+	std::uint64_t offset;
+	StoreRecord record;
+	if (!findRecord(name, offset, record)) return false;
+	copyRecordToState(record, state);
+	return true;
+}
+
+bool PetStore::updateState(const std::string& name, const PetState& state) {
+	std::uint64_t offset;
+	StoreRecord record;
+	if (!findRecord(name, offset, record)) return false;
+	copyStateToRecord(state, record);
+	return writeRecord(offset, record);
+}
+
+bool PetStore::remove(const std::string& name) {
+	std::uint64_t offset;
+	std::uint64_t previous;
+	StoreRecord record;
+	if (!findRecord(name, offset, record, &previous)) return false;
+
+	// Unlink from the bucket chain
+	if (previous == 0) {
+		std::uint64_t next = littleEndian(record.next);
+		if (!writeAt(bucketSlot(record.nameHash), &next, sizeof(next))) return false;
+	}
+	else {
+		StoreRecord previousRecord;
+		if (!readRecord(previous, previousRecord)) return false;
+		previousRecord.next = record.next;
+		if (!writeRecord(previous, previousRecord)) return false;
+	}
+
+	freeBlock(record.heapOffset, record.heapClass);
+	StoreRecord freeRecord = {};
+	freeRecord.next = header.freeRecords;
+	if (!writeRecord(offset, freeRecord)) return false;
+	header.freeRecords = offset;
+	header.petCount--;
+	return writeHeader();
+}
+
+std::vector<std::string> PetStore::names() {
+	std::vector<std::string> result;
+	if (!file.is_open()) return result;
+
+	std::vector<std::uint64_t> buckets(header.bucketCount);
+	if (!readAt(header.bucketOffset, buckets.data(), buckets.size() * sizeof(std::uint64_t))) return result;
+
+	result.reserve(static_cast<size_t>(header.petCount));
+	for (std::uint64_t head : buckets) {
+		std::uint64_t offset = littleEndian(head);
+		StoreRecord record;
+		while (offset != 0 && readRecord(offset, record)) {
+			std::string name;
+			if (readName(record, name)) result.push_back(std::move(name));
+			offset = record.next;
+		}
+	}
+	return result;
+}
@@ -0,0 +1,232 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "saveFormat.h"
+#include "coreLog.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+bool inBounds(std::uint64_t offset, std::uint64_t length, size_t size) {
+	return offset <= size && length <= size - offset;
+}
+
+template <typename T>
+void appendRecord(std::string& buffer, const T& record) {
+	buffer.append(reinterpret_cast<const char*>(&record), sizeof(T));
+}
+
+#ifdef _WIN32
+
+// Writes the whole buffer and returns once it is on disk
+bool writeFileDurably(const std::string& filename, const std::string& buffer) {
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		coreError() << "Failed to open save file for writing" << std::endl;
+		return false;
+	}
+	DWORD written = 0;
+	bool ok = WriteFile(file, buffer.data(), static_cast<DWORD>(buffer.size()), &written, nullptr) &&
+		written == buffer.size() && FlushFileBuffers(file);
+	CloseHandle(file);
+	if (!ok) coreError() << "Failed to write save file" << std::endl;
+	return ok;
+}
+
+// Atomically replaces `target`; write-through makes the rename itself durable
+bool replaceFileDurably(const std::string& source, const std::string& target) {
+	if (!MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+		coreError() << "Failed to replace save file (error " << GetLastError() << ")" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+#else
+
+bool writeFileDurably(const std::string& filename, const std::string& buffer) {
+	int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		coreError() << "Failed to open save file for writing" << std::endl;
+		return false;
+	}
+	const char* data = buffer.data();
+	size_t remaining = buffer.size();
+	while (remaining > 0) {
+		ssize_t written = ::write(fd, data, remaining);
+		if (written <= 0) break;
+		data += written;
+		remaining -= static_cast<size_t>(written);
+	}
+	bool ok = remaining == 0 && ::fsync(fd) == 0;
+	ok = ::close(fd) == 0 && ok;
+	if (!ok) coreError() << "Failed to write save file" << std::endl;
+	return ok;
+}
+
+// rename() is atomic; syncing the directory afterwards makes the new entry survive a crash
+bool replaceFileDurably(const std::string& source, const std::string& target) {
+	if (::rename(source.c_str(), target.c_str()) != 0) {
+		coreError() << "Failed to replace save file" << std::endl;
+		return false;
+	}
+	std::string directory = std::filesystem::path(target).parent_path().string();
+	int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+	if (fd < 0) return true;
+	::fsync(fd);
+	::close(fd);
+	return true;
+}
+
+#endif
+
+}
+
+std::uint32_t saveChecksum(const char* data, size_t size) {
+	std::uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= static_cast<std::uint8_t>(data[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+bool createSaveDirectory(const std::string& filename) {
+	namespace fs = std::filesystem;
+
+	// Create directory if it doesn't exist
+	fs::path savePath = fs::path(filename).parent_path();
+	if (!savePath.empty() && !fs::exists(savePath)) {
+		try {
+			coreError() << "Save directory not found, creating new directory" << std::endl;
+			fs::create_directories(savePath);
+		}
+		catch (const fs::filesystem_error& e) {
+			coreError() << "Failed to create save directory: " << e.what() << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+void encodePetSave(const PetSnapshot& snapshot, std::string& buffer) {
+	const PetState& state = snapshot.state;
+	std::uint32_t inventoryOffset = sizeof(SaveHeader) + sizeof(SavePetRecord);
+	std::uint32_t stringOffset = inventoryOffset + static_cast<std::uint32_t>(snapshot.inventory.size() * sizeof(SaveItemRecord));
+
+	SavePetRecord record = {};
+	record.lastUpdateTime = littleEndian<std::int64_t>(state.lastUpdateTime);
+	record.lastAgeTime = littleEndian<std::int64_t>(state.lastAgeTime);
+	record.birthTime = littleEndian<std::int64_t>(state.birthTime);
+	record.criticalHungerStartTime = littleEndian<std::int64_t>(state.criticalHungerStartTime);
+	record.criticalHealthStartTime = littleEndian<std::int64_t>(state.criticalHealthStartTime);
+	record.hunger = littleEndian<std::int32_t>(state.hunger);
+	record.happiness = littleEndian<std::int32_t>(state.happiness);
+	record.energy = littleEndian<std::int32_t>(state.energy);
+	record.cleanliness = littleEndian<std::int32_t>(state.cleanliness);
+	record.health = littleEndian<std::int32_t>(state.health);
+	record.age = littleEndian<std::int32_t>(state.age);
+	record.isAlive = state.isAlive ? 1 : 0;
+	record.isInCriticalHunger = state.isInCriticalHunger ? 1 : 0;
+	record.isInCriticalHealth = state.isInCriticalHealth ? 1 : 0;
+	record.nameOffset = littleEndian(stringOffset);
+	record.nameLength = littleEndian(static_cast<std::uint32_t>(snapshot.name.size()));
+	record.inventoryOffset = littleEndian(inventoryOffset);
+	record.inventoryCount = littleEndian(static_cast<std::uint32_t>(snapshot.inventory.size()));
+
+	buffer.clear();
+	buffer.reserve(stringOffset + snapshot.name.size());
+
+	buffer.resize(sizeof(SaveHeader));
+	appendRecord(buffer, record);
+
+	for (const auto& stack : snapshot.inventory) {
+		SaveItemRecord itemRecord = {};
+		itemRecord.catalogId = littleEndian(stack.catalogId);
+		itemRecord.count = littleEndian(stack.count);
+		appendRecord(buffer, itemRecord);
+	}
+
+	buffer += snapshot.name;
+
+	SaveHeader header = {};
+	std::memcpy(header.magic, SAVE_MAGIC, sizeof(SAVE_MAGIC));
+	header.version = littleEndian(SAVE_VERSION);
+	header.fileSize = littleEndian(static_cast<std::uint32_t>(buffer.size()));
+	header.checksum = littleEndian(saveChecksum(buffer.data() + sizeof(SaveHeader), buffer.size() - sizeof(SaveHeader)));
+	std::memcpy(buffer.data(), &header, sizeof(header));
+}
+
+bool writePetSave(const PetSnapshot& snapshot, const std::string& filename) {
+	if (!createSaveDirectory(filename)) return false;
+
+	std::string buffer;
+	encodePetSave(snapshot, buffer);
+
+	// Write beside the target, sync it and rename over it, so a crash leaves either the old
+	// save or the complete new one, never an empty or half-written file
+	std::string tempFilename = filename + ".tmp";
+	std::error_code error;
+	if (!writeFileDurably(tempFilename, buffer) || !replaceFileDurably(tempFilename, filename)) {
+		std::filesystem::remove(tempFilename, error);
+		return false;
+	}
+	return true;
+}
+
+bool isBinarySave(const char* data, size_t size) {
+	return size >= sizeof(SAVE_MAGIC) && std::memcmp(data, SAVE_MAGIC, sizeof(SAVE_MAGIC)) == 0;
+}
+
+const SavePetRecord* viewPetSave(const char* data, size_t size, std::uint32_t* version) {
+	if (size < sizeof(SaveHeader) + sizeof(SavePetRecord) || !isBinarySave(data, size)) {
+		coreError() << "Save file is truncated" << std::endl;
+		return nullptr;
+	}
+
+	const SaveHeader* header = reinterpret_cast<const SaveHeader*>(data);
+	std::uint32_t fileVersion = littleEndian(header->version);
+	if (fileVersion != 1 && fileVersion != SAVE_VERSION) {
+		coreError() << "Unsupported save file version " << fileVersion << std::endl;
+		return nullptr;
+	}
+	if (littleEndian(header->fileSize) != size) {
+		coreError() << "Save file size does not match its header" << std::endl;
+		return nullptr;
+	}
+	if (littleEndian(header->checksum) != saveChecksum(data + sizeof(SaveHeader), size - sizeof(SaveHeader))) {
+		coreError() << "Save file checksum mismatch" << std::endl;
+		return nullptr;
+	}
+
+	const SavePetRecord* record = reinterpret_cast<const SavePetRecord*>(data + sizeof(SaveHeader));
+	std::uint32_t inventoryOffset = littleEndian(record->inventoryOffset);
+	std::uint32_t inventoryCount = littleEndian(record->inventoryCount);
+	size_t itemSize = fileVersion == 1 ? sizeof(SaveItemRecordV1) : sizeof(SaveItemRecord);
+	if (!inBounds(littleEndian(record->nameOffset), littleEndian(record->nameLength), size) ||
+		inventoryOffset % 8 != 0 ||
+		!inBounds(inventoryOffset, static_cast<std::uint64_t>(inventoryCount) * itemSize, size)) {
+		coreError() << "Save file has invalid offsets" << std::endl;
+		return nullptr;
+	}
+
+	if (fileVersion == 1) {
+		const SaveItemRecordV1* items = reinterpret_cast<const SaveItemRecordV1*>(data + inventoryOffset);
+		for (std::uint32_t i = 0; i < inventoryCount; i++) {
+			if (!inBounds(littleEndian(items[i].nameOffset), littleEndian(items[i].nameLength), size)) {
+				coreError() << "Save file has invalid offsets" << std::endl;
+				return nullptr;
+			}
+		}
+	}
+	if (version) *version = fileVersion;
+	return record;
+}
@@ -0,0 +1,88 @@
+#include <utility>
+#include "saveWorker.h"
+
+SaveWorker::SaveWorker(const std::string& saveFile) :
+	filename(saveFile),
+	hasPending(false),
+	writing(false),
+	stopping(false),
+	writtenCount(0),
+	replacedCount(0),
+	failedCount(0),
+	thread(&SaveWorker::workerLoop, this) {
+}
+
+SaveWorker::~SaveWorker() {
+	stop();
+}
+
+void SaveWorker::submit(PetSnapshot& snapshot) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!stopping) {
+			if (hasPending) replacedCount++;
+			std::swap(pending, snapshot);
+			hasPending = true;
+			wake.notify_one();
+			return;
+		}
+	}
+	// Worker already stopped: nothing else will write it
+	bool ok = writePetSave(snapshot, filename);
+	std::lock_guard<std::mutex> lock(mutex);
+	(ok ? writtenCount : failedCount)++;
+}
+
+void SaveWorker::flush() {
+	std::unique_lock<std::mutex> lock(mutex);
+	idle.wait(lock, [this] { return !hasPending && !writing; });
+}
+
+void SaveWorker::stop() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (stopping) return;
+		stopping = true;
+	}
+	wake.notify_one();
+	if (thread.joinable()) thread.join();
+}
+
+void SaveWorker::workerLoop() {
+	// The second buffer: owned by this thread while it encodes and writes
+	PetSnapshot current;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [this] { return hasPending || stopping; });
+		if (!hasPending) break;
+
+		std::swap(current, pending);
+		hasPending = false;
+		writing = true;
+		lock.unlock();
+
+		bool ok = writePetSave(current, filename);
+
+		lock.lock();
+		writing = false;
+		(ok ? writtenCount : failedCount)++;
+		if (!hasPending) idle.notify_all();
+	}
+	idle.notify_all();
+}
+
+size_t SaveWorker::getWrittenCount() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return writtenCount;
+}
+
+size_t SaveWorker::getReplacedCount() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return replacedCount;
+}
+
+size_t SaveWorker::getFailedCount() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return failedCount;
+}
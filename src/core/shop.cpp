@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include "shop.h"
+#include "coreLog.h"
+
+PetShop::PetShop() :
+	shelfGenerations{},
+	depletedShelves(0),
+	restockTime(0),
+	playerMoney(balance().startingMoney),
+	generation(0) {
+		stock.fill(static_cast<std::uint32_t>(balance().shopStockPerItem));
+	}
+
+PetShop::~PetShop() {}
+
+	void PetShop::restockShop() {
+		if (depletedShelves == 0) return;
+
+		const std::uint32_t fullStock = static_cast<std::uint32_t>(balance().shopStockPerItem);
+		for (std::uint32_t shelves = depletedShelves; shelves != 0; shelves &= shelves - 1) {
+			size_t index = static_cast<size_t>(std::countr_zero(shelves));
+			stock[index] = fullStock;
+			shelfGenerations[index]++;
+		}
+		depletedShelves = 0;
+		generation++;
+	}
+
+	void PetShop::advanceTo(std::time_t now) {
+		if (depletedShelves != 0 && now >= restockTime) restockShop();
+	}
+
+	void PetShop::takeStock(size_t index, std::uint32_t quantity, std::time_t now) {
+		if (depletedShelves == 0) {
+			restockTime = now + static_cast<std::time_t>(balance().shopRestockMinutes) * 60;
+		}
+		stock[index] -= quantity;
+		shelfGenerations[index]++;
+		depletedShelves |= 1u << index;
+	}
+
+	bool PetShop::buyItem(size_t index, Pet* pet, std::time_t now) {
+		if (index >= SHOP_ITEMS.size()) {
+			return false;
+		}
+
+		advanceTo(now);
+		const Item& selectedItem = ItemCatalog::get().item(SHOP_ITEMS[index]);
+		if (pet && stock[index] > 0 && playerMoney >= selectedItem.getValue() &&
+			pet->getInventory().canAdd(SHOP_ITEMS[index], 1)) {
+			playerMoney -= selectedItem.getValue();
+			takeStock(index, 1, now);
+			generation++;
+
+			pet->addItemToInventory(SHOP_ITEMS[index]);
+			coreLog() << "Purchased " << selectedItem.getName() << " for "
+				<< selectedItem.getValue() << " coins" << std::endl;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool PetShop::buyItems(std::span<const PurchaseOrder> orders, Pet* pet, std::time_t now) {
+		if (!pet) return false;
+		advanceTo(now);
+
+		// Validate the whole batch before touching money, stock or inventory, so a failure
+		// leaves nothing to roll back
+		const ItemCatalog& catalog = ItemCatalog::get();
+		std::array<std::uint64_t, SHOP_ITEMS.size()> quantities = {};
+		std::uint64_t totalCost = 0;
+		std::uint64_t totalItems = 0;
+		for (const PurchaseOrder& order : orders) {
+			if (order.index >= SHOP_ITEMS.size()) return false;
+			quantities[order.index] += order.quantity;
+			totalItems += order.quantity;
+			totalCost += static_cast<std::uint64_t>(catalog.item(SHOP_ITEMS[order.index]).getValue()) * order.quantity;
+			// Checked per order so the running totals cannot overflow
+			if (totalCost > static_cast<std::uint64_t>(std::max(playerMoney, 0)) ||
+				quantities[order.index] > stock[order.index]) return false;
+		}
+		if (totalItems == 0) return false;
+
+		for (size_t i = 0; i < SHOP_ITEMS.size(); i++) {
+			if (quantities[i] > 0 && !pet->getInventory().canAdd(SHOP_ITEMS[i], quantities[i])) return false;
+		}
+
+		playerMoney -= static_cast<int>(totalCost);
+		generation++;
+		for (size_t i = 0; i < SHOP_ITEMS.size(); i++) {
+			if (quantities[i] == 0) continue;
+			takeStock(i, static_cast<std::uint32_t>(quantities[i]), now);
+			pet->addItemToInventory(SHOP_ITEMS[i], static_cast<std::uint32_t>(quantities[i]));
+		}
+		coreLog() << "Purchased " << totalItems << " items for " << totalCost << " coins" << std::endl;
+		return true;
+	}
+
+	int PetShop::getMoney() const { return playerMoney; }
+	void PetShop::addMoney(int amount) {
+		playerMoney += amount;
+		generation++;
+	}
+	std::uint64_t PetShop::getGeneration() const { return generation; }
+
+	std::span<const ItemId> PetShop::getShopItems() const {
+		return SHOP_ITEMS;
+	}
+
+	std::uint32_t PetShop::getStock(size_t index) const { return stock[index]; }
+	std::time_t PetShop::getRestockTime() const {
+		return depletedShelves != 0 ? restockTime : std::numeric_limits<std::time_t>::max();
+	}
+	std::uint64_t PetShop::getShelfGeneration(size_t index) const { return shelfGenerations[index]; }
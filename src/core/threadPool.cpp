@@ -0,0 +1,140 @@
+#include <algorithm>
+#include "threadPool.h"
+
+ThreadPool::ThreadPool(size_t threadCount) :
+	job(nullptr),
+	jobGeneration(0),
+	pendingTasks(0),
+	busyWorkers(0),
+	stopping(false),
+	stolenTasks(0) {
+	if (threadCount == 0) {
+		threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	for (size_t i = 0; i < threadCount; i++) {
+		queues.push_back(std::make_unique<WorkerQueue>());
+	}
+	for (size_t i = 1; i < threadCount; i++) {
+		workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		stopping = true;
+	}
+	jobReady.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+bool ThreadPool::popTask(size_t worker, size_t& task) {
+	{
+		WorkerQueue& own = *queues[worker];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty()) {
+			task = own.tasks.front();
+			own.tasks.pop_front();
+			return true;
+		}
+	}
+
+	for (size_t offset = 1; offset < queues.size(); offset++) {
+		WorkerQueue& victim = *queues[(worker + offset) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty()) {
+			task = victim.tasks.back();
+			victim.tasks.pop_back();
+			stolenTasks.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::runTasks(size_t worker, const std::function<void(size_t)>& fn) {
+	size_t task;
+	size_t done = 0;
+	while (popTask(worker, task)) {
+		fn(task);
+		done++;
+	}
+
+	std::lock_guard<std::mutex> lock(jobMutex);
+	pendingTasks -= done;
+	if (pendingTasks == 0) {
+		jobDone.notify_all();
+	}
+}
+
+void ThreadPool::workerLoop(size_t worker) {
+	size_t seenGeneration = 0;
+	while (true) {
+		const std::function<void(size_t)>* fn;
+		{
+			std::unique_lock<std::mutex> lock(jobMutex);
+			jobReady.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+			if (stopping) return;
+			seenGeneration = jobGeneration;
+			// Woke up after the job already finished
+			if (!job) continue;
+			fn = job;
+			busyWorkers++;
+		}
+
+		runTasks(worker, *fn);
+
+		std::lock_guard<std::mutex> lock(jobMutex);
+		busyWorkers--;
+		if (busyWorkers == 0) {
+			jobDone.notify_all();
+		}
+	}
+}
+
+void ThreadPool::parallelFor(size_t taskCount, const std::function<void(size_t)>& fn) {
+	if (taskCount == 0) return;
+
+	if (queues.size() == 1) {
+		for (size_t i = 0; i < taskCount; i++) {
+			fn(i);
+		}
+		return;
+	}
+
+	// Contiguous blocks per worker keep neighbouring shards on the same core
+	for (size_t w = 0; w < queues.size(); w++) {
+		size_t begin = taskCount * w / queues.size();
+		size_t end = taskCount * (w + 1) / queues.size();
+		std::lock_guard<std::mutex> lock(queues[w]->mutex);
+		for (size_t i = begin; i < end; i++) {
+			queues[w]->tasks.push_back(i);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		job = &fn;
+		pendingTasks = taskCount;
+		jobGeneration++;
+	}
+	jobReady.notify_all();
+
+	runTasks(0, fn);
+
+	// Barrier: every task finished and no worker still holds a reference to fn
+	std::unique_lock<std::mutex> lock(jobMutex);
+	jobDone.wait(lock, [&] { return pendingTasks == 0 && busyWorkers == 0; });
+	job = nullptr;
+}
+
+size_t ThreadPool::getThreadCount() const {
+	return queues.size();
+}
+
+size_t ThreadPool::getStolenTaskCount() const {
+	return stolenTasks.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,86 @@
+#include <limits>
+#include "timerWheel.h"
+
+TimerWheel::TimerWheel(std::time_t start) :
+	current(start),
+	timerCount(0) {
+}
+
+void TimerWheel::schedule(std::time_t expiry, std::uint64_t id) {
+	place({ expiry, id });
+	timerCount++;
+}
+
+void TimerWheel::place(const TimerEntry& entry) {
+	// Late timers fire on the next second processed
+	std::time_t expiry = entry.expiry < current ? current : entry.expiry;
+	std::time_t delta = expiry - current;
+
+	for (int level = 0; level < LEVELS; level++) {
+		if (delta < (std::time_t(1) << (SLOT_BITS * (level + 1)))) {
+			wheels[level][(expiry >> (SLOT_BITS * level)) & SLOT_MASK].push_back(entry);
+			return;
+		}
+	}
+	overflow.push_back(entry);
+}
+
+// Re-files the slot of `level` that covers the current time into the levels below
+void TimerWheel::cascade(int level) {
+	std::vector<TimerEntry> entries;
+	entries.swap(wheels[level][(current >> (SLOT_BITS * level)) & SLOT_MASK]);
+	for (const TimerEntry& entry : entries) {
+		place(entry);
+	}
+}
+
+void TimerWheel::advance(std::time_t now, std::vector<TimerEntry>& expired) {
+	while (current <= now) {
+		if (timerCount == 0) {
+			current = now + 1;
+			return;
+		}
+
+		// On each level boundary bring the next block of timers down a level
+		for (int level = 1; level < LEVELS; level++) {
+			if ((current & ((std::time_t(1) << (SLOT_BITS * level)) - 1)) != 0) break;
+			cascade(level);
+			if (level == LEVELS - 1 && ((current >> (SLOT_BITS * level)) & SLOT_MASK) == 0) {
+				std::vector<TimerEntry> entries;
+				entries.swap(overflow);
+				for (const TimerEntry& entry : entries) {
+					place(entry);
+				}
+			}
+		}
+
+		std::vector<TimerEntry>& slot = wheels[0][current & SLOT_MASK];
+		if (!slot.empty()) {
+			expired.insert(expired.end(), slot.begin(), slot.end());
+			timerCount -= slot.size();
+			slot.clear();
+		}
+		current++;
+	}
+}
+
+std::time_t TimerWheel::nextExpiry() const {
+	if (timerCount == 0) return std::numeric_limits<std::time_t>::max();
+
+	// Level 0 holds every timer due before the boundary; at the boundary itself the cascade
+	// into level 0 has not run yet, so nothing is known beyond it
+	std::time_t boundary = (current | SLOT_MASK) + 1;
+	if ((current & SLOT_MASK) == 0) return current;
+	for (std::time_t time = current; time < boundary; time++) {
+		if (!wheels[0][time & SLOT_MASK].empty()) return time;
+	}
+	return boundary;
+}
+
+size_t TimerWheel::size() const {
+	return timerCount;
+}
+
+std::time_t TimerWheel::getCurrentTime() const {
+	return current;
+}
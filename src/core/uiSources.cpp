@@ -0,0 +1,69 @@
+#include "uiSources.h"
+
+UiSources::UiSources() :
+	pet(nullptr),
+	petGeneration(0),
+	inventoryPet(nullptr),
+	inventoryGeneration(0),
+	shop(nullptr),
+	shopGeneration(0),
+	shelfGenerations{},
+	rebuildCount(0) {
+}
+
+bool UiSources::petChanged(const Pet& current) const {
+	return &current != pet || current.getGeneration() != petGeneration;
+}
+
+bool UiSources::inventoryChanged(const Pet& current) const {
+	return &current != inventoryPet || current.getInventoryGeneration() != inventoryGeneration;
+}
+
+bool UiSources::shopChanged(const PetShop& current) const {
+	return &current != shop || current.getGeneration() != shopGeneration;
+}
+
+bool UiSources::shelfChanged(const PetShop& current, size_t index) const {
+	return &current != shop || current.getShelfGeneration(index) != shelfGenerations[index];
+}
+
+UiRefresh UiSources::plan(const Pet& currentPet, const PetShop& currentShop, bool inventoryShown, bool shopShown) const {
+	bool alive = currentPet.getIsAlive();
+	return {
+		petChanged(currentPet),
+		alive && inventoryShown && inventoryChanged(currentPet),
+		alive && shopShown && shopChanged(currentShop)
+	};
+}
+
+void UiSources::markPet(const Pet& current) {
+	pet = &current;
+	petGeneration = current.getGeneration();
+	rebuildCount++;
+}
+
+void UiSources::markInventory(const Pet& current) {
+	inventoryPet = &current;
+	inventoryGeneration = current.getInventoryGeneration();
+	rebuildCount++;
+}
+
+// Shelves are marked by markShelf; a new shop leaves them stale until then
+void UiSources::markShop(const PetShop& current) {
+	if (&current != shop) shelfGenerations.fill(UINT64_MAX);
+	shop = &current;
+	shopGeneration = current.getGeneration();
+	rebuildCount++;
+}
+
+void UiSources::markShelf(const PetShop& current, size_t index) {
+	shelfGenerations[index] = current.getShelfGeneration(index);
+	rebuildCount++;
+}
+
+void UiSources::invalidateShop() {
+	shop = nullptr;
+	shelfGenerations.fill(UINT64_MAX);
+}
+
+size_t UiSources::getRebuildCount() const { return rebuildCount; }
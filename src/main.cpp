@@ -1,7 +1,17 @@
+#include <string>
+#include "balance.h"
 #include "game.h"
 
-int main() {
-	Game game;
+// Pass --live-state to keep the pet's stats in a memory-mapped file instead of saving them,
+// and --balance FILE to override game rules (see include/balance.def)
+int main(int argc, char* argv[]) {
+	bool useLiveState = false;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--live-state") useLiveState = true;
+		else if (arg == "--balance" && i + 1 < argc && !loadBalanceOverride(argv[++i])) return 1;
+	}
+	Game game(Clock::wall(), useLiveState);
 	game.run();
 	return 0;
-}
\ No newline at end of file
+}
@@ -1,5 +1,8 @@
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <filesystem>
+#include <limits>
 #include "game.h"
 #include "shop.h"
 
@@ -7,6 +10,8 @@ constexpr int WINDOW_WIDTH = 800;
 constexpr int WINDOW_HEIGHT = 450;
 constexpr int MAX_NAME_LENGTH = 15;
 
+constexpr const char* SCREEN_NAMES[SCREEN_COUNT] = { "name prompt", "main", "inventory", "shop", "item selection", "death" };
+
 void Game::loadAssets() {
 	if (!backgroundMusic.openFromFile("assets/audio/bgm.mp3")) {
 		std::cerr << "Failed to load audio!" << std::endl;
@@ -220,63 +225,128 @@ void Game::loadGameUI() {
 	closeSelectionText.setCharacterSize(16);
 	closeSelectionText.setFillColor(sf::Color::Black);
 	closeSelectionText.setPosition((WINDOW_WIDTH - closeSelectionText.getLocalBounds().width) / 2.0f, 370);
+
+	buildStaticBatches();
 }
 
-void Game::createNewPet(const std::string& name) {
-	pet.reset(new Pet(name));
+void Game::createNewPet(const std::string& name, bool resetShop) {
+	pet.reset(new Pet(name, clock));
+	if (resetShop) {
+		shop.reset(new PetShop());
+	}
+	// Log with the pet's own birth time so a replay recreates it exactly
+	actionLog.recordNewPet(pet->getState().birthTime, name, resetShop);
+	attachLiveState();
+	schedulePet();
 	isCreatingNewPet = false;
 	isInputActive = false;
 	std::cout << "Created new pet named: " << name << std::endl;
 }
 
-void Game::showItemsByCategory(const std::string& category) {
+// Pet updates are driven by its predicted events rather than by every frame
+void Game::schedulePet() {
+	scheduler = std::make_unique<PetScheduler>(clock.now());
+	scheduledPetId = scheduler->addPet(pet.get());
+}
+
+// Move the pet's stats into the live file. A state committed there for the same pet wins
+// only if it is newer than the one loaded: a normal session since then may have saved
+// newer stats and left the live file behind.
+void Game::attachLiveState() {
+	if (!liveState.isOpen()) return;
+
+	PetState recovered;
+	if (liveState.recover(recovered) && recovered.birthTime == pet->getState().birthTime &&
+		recovered.lastUpdateTime > pet->getState().lastUpdateTime) {
+		PetSnapshot snapshot = pet->snapshot();
+		snapshot.state = recovered;
+		pet->restore(snapshot);
+	}
+	pet->attachState(liveState.getState());
+	liveState.commit();
+	liveCommitClock.restart();
+}
+
+// A normal session after a live one: live sessions keep the stats out of the save until
+// exit, so after a crash the live file may hold a newer state for the same pet. Adopt it
+// and leave the file alone; once the save catches up the file is simply older than it.
+bool Game::adoptLiveState() {
+	if (!liveState.openReadOnly(liveStatePath)) return false;
+
+	PetState recovered;
+	bool adopted = liveState.recover(recovered) &&
+		recovered.birthTime == pet->getState().birthTime &&
+		recovered.lastUpdateTime > pet->getState().lastUpdateTime;
+	if (adopted) {
+		PetSnapshot snapshot = pet->snapshot();
+		snapshot.state = recovered;
+		pet->restore(snapshot);
+		std::cout << "Recovered newer pet state from " << liveStatePath << std::endl;
+	}
+	liveState.close();
+	return adopted;
+}
+
+// Snapshot the pet as the session starts; the action log replays on top of it
+void Game::startActionLog() {
+	std::time_t now = clock.now();
+	pet->update(now);
+	if (pet->savePetToFile(sessionSnapshotPath)) {
+		actionLog.open(actionLogPath, now, shop->getMoney());
+	}
+}
+
+// Stale handles (the stack ran out since the screen was built) are ignored
+void Game::useInventoryItem(InventoryHandle handle) {
+	const InventoryStack* stack = pet->getInventory().find(handle);
+	if (!stack) return;
+
+	// Logged by catalog ID, since handles depend on the pet's slot history
+	ItemId itemId = stack->catalogId;
+	if (pet->useItemFromInventory(handle)) {
+		actionLog.record(clock.now(), ACTION_USE_ITEM, itemId);
+	}
+}
+
+void Game::showItemsByType(ItemType type) {
 	showingItemSelection = true;
-	currentSelectionCategory = category;
-	updateSelectionUI(category);
+	currentSelectionType = type;
+	updateSelectionUI(type);
 }
 
-void  Game::updateSelectionUI(const std::string& category) {
+void  Game::updateSelectionUI(ItemType type) {
 	// Clear previous selection UI elements
 	selectionItemBoxes.clear();
 	selectionItemTexts.clear();
 
-	// Set the title based on category
+	// Set the title based on item type
 	std::string titleText;
-	if (category == "Food") {
+	if (type == ITEM_FOOD) {
 		titleText = "Select Food Item";
 	}
-	else if (category == "Medicine") {
+	else if (type == ITEM_MEDICINE) {
 		titleText = "Select Medicine";
 	}
 	selectionTitle.setString(titleText);
 	selectionTitle.setPosition((WINDOW_WIDTH - selectionTitle.getLocalBounds().width) / 2.0f, 60);
 
 	// Get inventory items from pet
+	const ItemCatalog& catalog = ItemCatalog::get();
 	const auto& inventory = pet->getInventory();
 
-	// Filter items by category
-	std::vector<size_t> selectionIndex;
-	for (size_t i = 0; i < inventory.size(); i++) {
-		bool matchesCategory = false;
-		if (category == "Food" && dynamic_cast<const FoodItem*>(inventory[i].get())) {
-			matchesCategory = true;
-		}
-		else if (category == "Medicine" && dynamic_cast<const MedicineItem*>(inventory[i].get())) {
-			matchesCategory = true;
-		}
-
-		if (matchesCategory) {
-			selectionIndex.push_back(i);
-		}
-	}
+	// Stacks of this type, kept up to date by the pet. Clicks use these handles, so a box that
+	// outlived its stack does nothing instead of using another item.
+	auto handles = inventory.getHandlesByType(type);
+	selectionHandles.assign(handles.begin(), handles.end());
 
 	float startY = 100;
 	float itemHeight = 40;
 	float spacing = 10;
 
 	// Create selection item UI elements
-	for (size_t i = 0; i < selectionIndex.size(); i++) {
-		size_t origIndex = selectionIndex[i];
+	for (size_t i = 0; i < selectionHandles.size(); i++) {
+		const InventoryStack& stack = *inventory.find(selectionHandles[i]);
+		const Item& item = catalog.item(stack.catalogId);
 		sf::RectangleShape itemBox;
 		itemBox.setSize(sf::Vector2f(500, itemHeight));
 		itemBox.setFillColor(sf::Color(189, 252, 201));
@@ -287,23 +357,21 @@ void  Game::updateSelectionUI(const std::string& category) {
 
 		sf::Text itemText;
 		itemText.setFont(font);
-		itemText.setString(inventory[origIndex]->getName());
+		itemText.setString(item.getName());
 		itemText.setCharacterSize(16);
 		itemText.setFillColor(sf::Color::Black);
 		itemText.setPosition((WINDOW_WIDTH - 480) / 2.0f, startY + (itemHeight + spacing) * i + 10);
 
-		// Store the original index in the user data
-		// We'll use this to retrieve the correct item when selected
-		itemText.setString(inventory[origIndex]->getName() + " (Value: " +
-			std::to_string(inventory[origIndex]->getValue()) + ")");
+		itemText.setString(item.getName() + " x" + std::to_string(stack.count) + " (Value: " +
+			std::to_string(item.getValue()) + ")");
 		selectionItemTexts.push_back(itemText);
 	}
 
-	// If no items of this category, show message
-	if (selectionIndex.empty()) {
+	// If no items of this type, show message
+	if (selectionHandles.empty()) {
 		sf::Text emptyText;
 		emptyText.setFont(font);
-		emptyText.setString("No " + category + " items in your inventory.");
+		emptyText.setString(std::string("No ") + itemTypeName(type) + " items in your inventory.");
 		emptyText.setCharacterSize(18);
 		emptyText.setFillColor(sf::Color::Black);
 		emptyText.setPosition(
@@ -312,21 +380,113 @@ void  Game::updateSelectionUI(const std::string& category) {
 		);
 		selectionItemTexts.push_back(emptyText);
 	}
+
+	selectionBatch.clear();
+	selectionBatch.addRectangle(selectionBackground);
+	for (const auto& box : selectionItemBoxes) {
+		selectionBatch.addRectangle(box);
+	}
+	selectionBatch.addRectangle(closeSelectionButton);
 }
 
 void Game::updateUI() {
+	frameDrawCalls = 0;
 	if (isFirstLaunch) {
 		window.clear(sf::Color(240, 240, 240));
-		window.draw(deathBox);
-		window.draw(namePromptText);
-		window.draw(nameInputBox);
-		window.draw(nameInputText);
-		window.draw(newPetButton);
-		window.draw(newPetButtonLabel);
+		draw(namePromptBatch);
+		draw(namePromptText);
+		draw(nameInputText);
+		draw(newPetButtonLabel);
+		reportDrawCalls(SCREEN_NAME_PROMPT);
 		window.display();
 		return;
 	}
 
+	// Widgets are only rebuilt when the pet or shop generation they were built from moved
+	UiRefresh refresh = uiSources.plan(*pet, *shop, showingInventory, showingShop);
+	if (refresh.pet) refreshPetUI();
+	if (refresh.inventory) updateInventoryUI();
+	if (refresh.shop) refreshShopStock();
+
+	window.clear(sf::Color(240, 240, 240));
+	draw(backgroundSprite);
+
+	draw(petSprite);
+
+	// Each batch goes first, so the texts of its layer are drawn over it
+	UiScreen screen;
+	if (pet->getIsAlive()) {
+		if (showingInventory) {
+			screen = SCREEN_INVENTORY;
+			draw(inventoryBatch);
+			draw(inventoryTitle);
+			for (const auto& text : inventoryItemTexts) {
+				draw(text);
+			}
+			draw(closeInventoryText);
+		}
+		else if (showingShop) {
+			screen = SCREEN_SHOP;
+			draw(shopBatch);
+			draw(shopTitle);
+			for (const auto& text : shopItemTexts) {
+				draw(text);
+			}
+			for (const auto& text : shopStockTexts) {
+				draw(text);
+			}
+			draw(moneyText);
+			draw(closeShopText);
+		}
+		else if (showingItemSelection) {
+			screen = SCREEN_SELECTION;
+			draw(selectionBatch);
+			draw(selectionTitle);
+			for (const auto& text : selectionItemTexts) {
+				draw(text);
+			}
+			draw(closeSelectionText);
+		}
+		else {
+			screen = SCREEN_MAIN;
+			draw(heartBatch);
+			for (const auto& text : *statusTexts) {
+				draw(text);
+			}
+			draw(nameAgeText);
+			draw(moodText);
+
+			draw(buttonBatch);
+			for (const auto& label : *buttonLabels) {
+				draw(label);
+			}
+		}
+	}
+	else {
+		if (!isCreatingNewPet) {
+			screen = SCREEN_DEATH;
+			draw(deathBatch);
+			draw(deathTitle);
+			draw(deathMessage);
+			draw(newPetButtonLabel);
+		}
+		else {
+			screen = SCREEN_NAME_PROMPT;
+			draw(namePromptBatch);
+			draw(namePromptText);
+			draw(nameInputText);
+			draw(newPetButtonLabel);
+		}
+	}
+
+	reportDrawCalls(screen);
+	window.display();
+}
+
+// Hearts, name, age, mood and sprite, or the death message
+void Game::refreshPetUI() {
+	uiSources.markPet(*pet);
+
 	if (pet->getIsAlive()) {
 		int stats[5] = {
 			100 - pet->getHunger(),
@@ -341,30 +501,22 @@ void Game::updateUI() {
 			// Heart transparency when empty
 			for (int j = 0; j < 5; j++) {
 				(*hearts)[i][j].setColor(j < heartsToShow ? sf::Color::White : sf::Color(255, 255, 255, 50));
+				heartBatch.setQuadColor(static_cast<size_t>(i * 5 + j), (*hearts)[i][j].getColor());
 			}
 		}
 
 		nameAgeText.setString(pet->getName() + " - Age: " + std::to_string(pet->getAge()) + " days");
 		moodText.setString("Mood: " + pet->getMood());
 
+		const BalanceTable& rules = balance();
 		PetMood mood = NORMAL;
-		if (pet->getHunger() > 80) mood = HUNGRY;
-		else if (pet->getEnergy() < 20) mood = TIRED;
-		else if (pet->getCleanliness() < 30) mood = DIRTY;
-		else if (pet->getHappiness() < 30) mood = SAD;
-		else if (pet->getHappiness() > 80) mood = HAPPY;
+		if (pet->getHunger() > rules.moodHungryAbove) mood = HUNGRY;
+		else if (pet->getEnergy() < rules.moodTiredBelow) mood = TIRED;
+		else if (pet->getCleanliness() < rules.moodDirtyBelow) mood = DIRTY;
+		else if (pet->getHappiness() < rules.moodSadBelow) mood = SAD;
+		else if (pet->getHappiness() > rules.moodHappyAbove) mood = HAPPY;
 
 		petSprite.setTexture((*petTextures)[mood]);
-
-		// Update inventory UI if showing
-		if (showingInventory) {
-			updateInventoryUI();
-		}
-
-		// Update shop UI if showing
-		if (showingShop) {
-			updateShopUI();
-		}
 	}
 	else {
 		std::string petName = pet->getName();
@@ -380,121 +532,75 @@ void Game::updateUI() {
 
 		// Set sprite to dead texture
 		petSprite.setTexture((*petTextures)[DEAD]);
-
-		if (isCreatingNewPet) {
-			nameInputText.setString(inputName + (isInputActive ? "_" : ""));
-		}
 	}
+}
 
-	window.clear(sf::Color(240, 240, 240));
-	window.draw(backgroundSprite);
-
-	window.draw(petSprite);
-
-	if (pet->getIsAlive()) {
-		if (showingInventory) {
-			// Draw inventory UI
-			window.draw(inventoryBackground);
-			window.draw(inventoryTitle);
-
-			for (const auto& box : inventoryItemBoxes) {
-				window.draw(box);
-			}
-
-			for (const auto& text : inventoryItemTexts) {
-				window.draw(text);
-			}
-
-			window.draw(closeInventoryButton);
-			window.draw(closeInventoryText);
-		}
-		else if (showingShop) {
-			// Draw shop UI
-			window.draw(shopBackground);
-			window.draw(shopTitle);
-
-			for (const auto& box : shopItemBoxes) {
-				window.draw(box);
-			}
-
-			for (const auto& text : shopItemTexts) {
-				window.draw(text);
-			}
-
-			window.draw(moneyText);
-			window.draw(closeShopButton);
-			window.draw(closeShopText);
+// Layouts that never change after loadGameUI
+void Game::buildStaticBatches() {
+	heartBatch.clear(&heartTexture);
+	for (const auto& row : *hearts) {
+		for (const auto& heart : row) {
+			heartBatch.addSprite(heart);
 		}
-		else if (showingItemSelection) {
-			// Draw item selection UI
-			window.draw(selectionBackground);
-			window.draw(selectionTitle);
+	}
 
-			for (const auto& box : selectionItemBoxes) {
-				window.draw(box);
-			}
+	buttonBatch.clear();
+	for (const auto& button : *buttons) {
+		buttonBatch.addRectangle(button);
+	}
 
-			for (const auto& text : selectionItemTexts) {
-				window.draw(text);
-			}
+	deathBatch.clear();
+	deathBatch.addRectangle(deathBox);
+	deathBatch.addRectangle(newPetButton);
 
-			window.draw(closeSelectionButton);
-			window.draw(closeSelectionText);
-		}
-		else {
-			// Draw main game UI
-			for (int i = 0; i < 5; i++) {
-				window.draw((*statusTexts)[i]);
-				for (int j = 0; j < 5; j++)
-					window.draw((*hearts)[i][j]);
-			}
+	namePromptBatch.clear();
+	namePromptBatch.addRectangle(deathBox);
+	namePromptBatch.addRectangle(nameInputBox);
+	namePromptBatch.addRectangle(newPetButton);
+}
 
-			window.draw(nameAgeText);
-			window.draw(moodText);
+void Game::draw(const sf::Drawable& drawable) {
+	window.draw(drawable);
+	frameDrawCalls++;
+}
 
-			for (int i = 0; i < 7; i++) {
-				window.draw((*buttons)[i]);
-				window.draw((*buttonLabels)[i]);
-			}
-		}
-	}
-	else {
-		if (!isCreatingNewPet) {
-			// Draw death message and new pet button
-			window.draw(deathBox);
-			window.draw(deathTitle);
-			window.draw(deathMessage);
-			window.draw(newPetButton);
-			window.draw(newPetButtonLabel);
-		}
-		else {
-			// Draw new pet creation UI
-			window.draw(deathBox);
-			window.draw(namePromptText);
-			window.draw(nameInputBox);
-			window.draw(nameInputText);
-			window.draw(newPetButton);
-			window.draw(newPetButtonLabel);
-		}
-	}
+void Game::draw(const QuadBatch& batch) {
+	if (batch.getQuadCount() == 0) return;
+	batch.draw(window);
+	frameDrawCalls++;
+}
 
-	window.display();
+void Game::reportDrawCalls(UiScreen screen) {
+	if (reportedDrawCalls[screen] == frameDrawCalls) return;
+	reportedDrawCalls[screen] = frameDrawCalls;
+	std::cout << "Draw calls on the " << SCREEN_NAMES[screen] << " screen: " << frameDrawCalls << std::endl;
 }
 
 void Game::updateInventoryUI() {
+	uiSources.markInventory(*pet);
+
 	// Clear previous inventory UI elements
 	inventoryItemBoxes.clear();
 	inventoryItemTexts.clear();
 
 	// Get inventory items from pet
+	const ItemCatalog& catalog = ItemCatalog::get();
 	const auto& inventory = pet->getInventory();
 
 	float startY = 100;
 	float itemHeight = 40;
 	float spacing = 10;
 
-	// Create inventory item UI elements
-	for (size_t i = 0; i < inventory.size(); i++) {
+	// Create inventory item UI elements, grouped by type
+	inventoryHandles.clear();
+	for (int type = 0; type < ITEM_TYPE_COUNT; type++) {
+		auto handles = inventory.getHandlesByType(static_cast<ItemType>(type));
+		inventoryHandles.insert(inventoryHandles.end(), handles.begin(), handles.end());
+	}
+
+	for (size_t i = 0; i < inventoryHandles.size(); i++) {
+		const InventoryStack& stack = *inventory.find(inventoryHandles[i]);
+		const Item& item = catalog.item(stack.catalogId);
 		sf::RectangleShape itemBox;
 		itemBox.setSize(sf::Vector2f(500, itemHeight));
 		itemBox.setFillColor(sf::Color(220, 220, 220));
@@ -507,14 +613,10 @@ void Game::updateInventoryUI() {
 		itemText.setFont(font);
 
 		// Get item type string
-		std::string itemTypeStr;
-		if (dynamic_cast<const FoodItem*>(inventory[i].get()))
-			itemTypeStr = "[Food]";
-		else if (dynamic_cast<const MedicineItem*>(inventory[i].get()))
-			itemTypeStr = "[Medicine]";
-
-		itemText.setString(itemTypeStr + " " + inventory[i]->getName() + " (Value: " +
-			std::to_string(inventory[i]->getValue()) + ")");
+		std::string itemTypeStr = std::string("[") + itemTypeName(item.getType()) + "]";
+
+		itemText.setString(itemTypeStr + " " + item.getName() + " x" + std::to_string(stack.count) +
+			" (Value: " + std::to_string(item.getValue()) + ")");
 		itemText.setCharacterSize(16);
 		itemText.setFillColor(sf::Color::Black);
 		itemText.setPosition((WINDOW_WIDTH - 480) / 2.0f, startY + (itemHeight + spacing) * i + 10);
@@ -534,6 +636,13 @@ void Game::updateInventoryUI() {
 		);
 		inventoryItemTexts.push_back(emptyText);
 	}
+
+	inventoryBatch.clear();
+	inventoryBatch.addRectangle(inventoryBackground);
+	for (const auto& box : inventoryItemBoxes) {
+		inventoryBatch.addRectangle(box);
+	}
+	inventoryBatch.addRectangle(closeInventoryButton);
 }
 
 void Game::updateShopUI() {
@@ -546,15 +655,10 @@ void Game::updateShopUI() {
 	std::map<std::string, std::vector<std::pair<size_t, const Item*>>> categorizedItems;
 
 	for (size_t i = 0; i < shopItems.size(); i++) {
-		std::string category;
-		if (dynamic_cast<const FoodItem*>(shopItems[i].get()))
-			category = "Food";
-		else if (dynamic_cast<const MedicineItem*>(shopItems[i].get()))
-			category = "Medicine";
-		else
-			category = "Other";
+		const Item* item = &ItemCatalog::get().item(shopItems[i]);
+		std::string category = itemTypeName(item->getType());
 
-		categorizedItems[category].push_back({ i, shopItems[i].get() });
+		categorizedItems[category].push_back({ i, item });
 	}
 
 	// UI layout parameters
@@ -566,11 +670,6 @@ void Game::updateShopUI() {
 	float leftX = (WINDOW_WIDTH - (2 * columnWidth) - 40) / 2.0f;
 	float rightX = leftX + columnWidth + 30;
 
-	// Store mapping of UI box index to shop item index for click handling
-	std::vector<size_t> boxToItemIndex;
-
-	moneyText.setString("Money: " + std::to_string(shop->getMoney()) + " coins");
-
 	auto createCategoryHeader = [&](const std::string& category, float x, float y) {
 		sf::Text categoryText;
 		categoryText.setFont(font);
@@ -596,7 +695,6 @@ void Game::updateShopUI() {
 			itemBox.setOutlineThickness(1);
 			itemBox.setPosition(leftX, leftCurrentY);
 			shopItemBoxes.push_back(itemBox);
-			boxToItemIndex.push_back(itemIndex);
 
 			// Create item text
 			sf::Text itemText;
@@ -627,7 +725,6 @@ void Game::updateShopUI() {
 			itemBox.setOutlineThickness(1);
 			itemBox.setPosition(rightX, rightCurrentY);
 			shopItemBoxes.push_back(itemBox);
-			boxToItemIndex.push_back(itemIndex);
 
 			sf::Text itemText;
 			itemText.setFont(font);
@@ -641,26 +738,72 @@ void Game::updateShopUI() {
 			rightCurrentY += itemHeight + spacing;
 		}
 	}
+
+	shopBatch.clear();
+	shopBatch.addRectangle(shopBackground);
+	for (const auto& box : shopItemBoxes) {
+		shopBatch.addRectangle(box);
+	}
+	shopBatch.addRectangle(closeShopButton);
+
+	// Boxes were added in shelf order, which setShelfStockText relies on
+	uiSources.invalidateShop();
+	refreshShopStock();
+}
+
+// Money and the stock of shelves that changed since the shop screen last looked
+void Game::refreshShopStock() {
+	if (!uiSources.shopChanged(*shop)) return;
+	uiSources.markShop(*shop);
+	moneyText.setString("Money: " + std::to_string(shop->getMoney()) + " coins");
+
+	for (size_t i = 0; i < SHOP_ITEMS.size(); i++) {
+		if (uiSources.shelfChanged(*shop, i)) setShelfStockText(i);
+	}
+}
+
+void Game::setShelfStockText(size_t index) {
+	uiSources.markShelf(*shop, index);
+
+	std::uint32_t stock = shop->getStock(index);
+	sf::Text& stockText = shopStockTexts[index];
+	stockText.setFont(font);
+	stockText.setString(stock > 0 ? std::to_string(stock) + " left" : "Sold out");
+	stockText.setCharacterSize(11);
+	stockText.setFillColor(stock > 0 ? sf::Color(80, 80, 80) : sf::Color::Red);
+
+	const sf::RectangleShape& box = shopItemBoxes[index];
+	stockText.setPosition(box.getPosition().x + box.getSize().x - stockText.getLocalBounds().width - 5,
+		box.getPosition().y + 2);
 }
 
-void Game::handleEvents() {
+bool Game::handleEvents() {
+	bool handled = false;
 	sf::Event event;
 	while (window.pollEvent(event)) {
+		handled = true;
 		switch (event.type) {
+		case sf::Event::LostFocus:
+			enterBackground();
+			break;
+
+		case sf::Event::GainedFocus:
+			leaveBackground();
+			break;
+
 		case sf::Event::Closed:
-			// Save the pet's state before closing
-			if (shouldSaveOnExit) {
-				pet->savePetToFile(saveFilePath);
+			// Save the pet's state before closing. Write the stats too, not just the inventory,
+			// so the save is complete on its own and a later normal session starts from it.
+			autosaver.setStatsLive(false);
+			if (shouldSaveOnExit && autosaver.flush(*pet)) {
 				std::cout << "Pet state saved" << std::endl;
 			}
+			autosaver.finish();
+			liveState.commit(true);
+			actionLog.flush();
 			window.close();
 			break;
 
-		case sf::Event::LostFocus:
-			// Reset the background update clock when focus is lost
-			backgroundUpdateClock.restart();
-			break;
-
 		case sf::Event::TextEntered:
 			if ((isCreatingNewPet || isFirstLaunch) && isInputActive) {
 				if (event.text.unicode == 8 && !inputName.empty()) {
@@ -694,9 +837,8 @@ void Game::handleEvents() {
 
 					if (newPetButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
 						if (!inputName.empty()) {
-							createNewPet(inputName);
+							createNewPet(inputName, true);
 							isFirstLaunch = false;
-							shop.reset(new PetShop());
 						}
 					}
 				}
@@ -722,6 +864,7 @@ void Game::handleEvents() {
 							}
 						}
 					}
+					nameInputText.setString(inputName + (isInputActive ? "_" : ""));
 				}
 				// Showing item selection
 				else if (showingItemSelection) {
@@ -731,30 +874,12 @@ void Game::handleEvents() {
 					}
 
 					// Check if an item is clicked
-					const auto& inventory = pet->getInventory();
-					std::vector<size_t> filteredIndices;
-
-					// Filter items by category
-					for (size_t i = 0; i < inventory.size(); i++) {
-						bool matchesCategory = false;
-						if (currentSelectionCategory == "Food" && dynamic_cast<const FoodItem*>(inventory[i].get())) {
-							matchesCategory = true;
-						}
-						else if (currentSelectionCategory == "Medicine" && dynamic_cast<const MedicineItem*>(inventory[i].get())) {
-							matchesCategory = true;
-						}
-
-						if (matchesCategory) {
-							filteredIndices.push_back(i);
-						}
-					}
-
-					for (size_t i = 0; i < selectionItemBoxes.size() && i < filteredIndices.size(); i++) {
+					for (size_t i = 0; i < selectionItemBoxes.size() && i < selectionHandles.size(); i++) {
 						if (selectionItemBoxes[i].getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
 							// Use the item
-							pet->useItemFromInventory(filteredIndices[i]);
+							useInventoryItem(selectionHandles[i]);
 							// Update the selection UI
-							updateSelectionUI(currentSelectionCategory);
+							updateSelectionUI(currentSelectionType);
 							break;
 						}
 					}
@@ -766,9 +891,9 @@ void Game::handleEvents() {
 					}
 
 					// Check if an inventory item is clicked
-					for (size_t i = 0; i < inventoryItemBoxes.size(); i++) {
+					for (size_t i = 0; i < inventoryItemBoxes.size() && i < inventoryHandles.size(); i++) {
 						if (inventoryItemBoxes[i].getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
-							pet->useItemFromInventory(i);
+							useInventoryItem(inventoryHandles[i]);
 							updateInventoryUI();
 							break;
 						}
@@ -781,10 +906,12 @@ void Game::handleEvents() {
 
 					for (size_t i = 0; i < shopItemBoxes.size(); i++) {
 						if (shopItemBoxes[i].getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
-							// Try to buy the item
-							shop->buyItem(i, pet.get());
-							// Update the shop UI
-							updateShopUI();
+							// Try to buy the item; the log gets the same time the restock is scheduled from
+							std::time_t now = clock.now();
+							if (shop->buyItem(i, pet.get(), now)) {
+								actionLog.record(now, ACTION_BUY_ITEM, i);
+							}
+							// The next frame redraws the money and this shelf's stock
 							break;
 						}
 					}
@@ -795,13 +922,22 @@ void Game::handleEvents() {
 						if ((*buttons)[i].getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
 							switch (i) {
 							case 0:
-								showItemsByCategory("Food");
+								showItemsByType(ITEM_FOOD);
+								break;
+							case 1:
+								pet->play();
+								actionLog.record(clock.now(), ACTION_PLAY);
+								break;
+							case 2:
+								pet->sleep();
+								actionLog.record(clock.now(), ACTION_SLEEP);
+								break;
+							case 3:
+								pet->clean();
+								actionLog.record(clock.now(), ACTION_CLEAN);
 								break;
-							case 1: pet->play(); break;
-							case 2: pet->sleep(); break;
-							case 3: pet->clean(); break;
 							case 4:
-								showItemsByCategory("Medicine");
+								showItemsByType(ITEM_MEDICINE);
 								break;
 							case 5:
 								showingInventory = true;
@@ -815,23 +951,71 @@ void Game::handleEvents() {
 						}
 					}
 				}
+
+				// A click may have fed, played with or medicated the pet
+				scheduler->reschedule(scheduledPetId);
 			}
 			break;
 		}
 	}
+	return handled;
 }
 
-Game::Game() : window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT),
+void Game::enterBackground() {
+	if (inBackground) return;
+	inBackground = true;
+	musicOffset = backgroundMusic.getPlayingOffset();
+	backgroundMusic.stop();
+}
+
+void Game::leaveBackground() {
+	if (!inBackground) return;
+	inBackground = false;
+	backgroundMusic.setPlayingOffset(musicOffset);
+	backgroundMusic.play();
+}
+
+// How long the loop can sleep before the next scheduled work, at most `cap` seconds. Event
+// times are converted with the system clock, so only the wall clock gives a shorter sleep.
+float Game::secondsUntilWork(float cap) const {
+	double seconds = cap;
+	if (&clock == &Clock::wall()) {
+		auto untilTime = [](std::time_t time) {
+			if (time == std::numeric_limits<std::time_t>::max()) return std::numeric_limits<double>::infinity();
+			return std::chrono::duration<double>(std::chrono::system_clock::from_time_t(time) -
+				std::chrono::system_clock::now()).count();
+		};
+		seconds = std::min({ seconds, untilTime(scheduler->nextDueTime()), untilTime(shop->getRestockTime()) });
+	}
+	seconds = std::min(seconds, autosaver.secondsUntilSave(*pet));
+	if (liveState.isOpen() && pet->getGeneration() != liveCommittedGeneration) {
+		seconds = std::min(seconds, static_cast<double>(LIVE_COMMIT_INTERVAL - liveCommitClock.getElapsedTime().asSeconds()));
+	}
+	return static_cast<float>(std::max(seconds, 0.0));
+}
+
+// Moves whenever the pet's stats or inventory or the shop change; all three only grow
+std::uint64_t Game::getSceneGeneration() const {
+	return pet->getGeneration() + pet->getInventoryGeneration() + shop->getGeneration();
+}
+
+Game::Game(const Clock& simClock, bool useLiveState) : clock(simClock),
+	window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT),
 	"Tama Tama",
 	sf::Style::Titlebar | sf::Style::Close),
+	scheduledPetId(0),
 	shouldSaveOnExit(true),
+	liveCommittedGeneration(0),
+	drawnSceneGeneration(UINT64_MAX),
+	inBackground(false),
 	isCreatingNewPet(false),
 	isInputActive(false),
 	isFirstLaunch(false),
 	showingInventory(false),
 	showingShop(false),
 	showingItemSelection(false),
-	currentSelectionCategory("") {
+	currentSelectionType(ITEM_FOOD),
+	frameDrawCalls(0) {
 
 	// Initialize
 	petTextures = std::make_unique<std::array<sf::Texture, 7>>();
@@ -840,14 +1024,18 @@ Game::Game() : window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT),
 	buttons = std::make_unique<std::array<sf::RectangleShape, 7>>();
 	buttonLabels = std::make_unique<std::array<sf::Text, 7>>();
 
-	pet = std::make_unique<Pet>("Tama kun");
+	pet = std::make_unique<Pet>("Tama kun", clock);
 	shop = std::make_unique<PetShop>();
 
+	window.setFramerateLimit(FRAME_RATE_LIMIT);
+	reportedDrawCalls.fill(SIZE_MAX);
+
 	srand(static_cast<unsigned int>(time(nullptr)));
 	loadAssets();
 	loadGameUI();
 
 	bool saveFileExists = false;
+	bool petLoaded = false;
 
 	try {
 		std::filesystem::path savePath(saveFilePath);
@@ -871,6 +1059,7 @@ Game::Game() : window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT),
 	else {
 		if (pet->loadPetFromFile(saveFilePath)) {
 			std::cout << "Pet loaded from save file: " << saveFilePath << std::endl;
+			petLoaded = true;
 		}
 		else {
 			std::cout << "Save file exists but could not be loaded. Starting with pet creation." << std::endl;
@@ -884,7 +1073,21 @@ Game::Game() : window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT),
 		}
 	}
 
-	backgroundUpdateClock.restart();
+	if (useLiveState) {
+		if (liveState.open(liveStatePath)) {
+			autosaver.setStatsLive(true);
+			attachLiveState();
+		}
+	}
+	else if (petLoaded && adoptLiveState()) {
+		// The adopted stats are not in the save yet, so leave the pet dirty
+		petLoaded = false;
+	}
+	// Baseline only once the stats mode is settled, or switching it would read as an unsaved change
+	if (petLoaded) autosaver.markSaved(*pet);
+
+	startActionLog();
+	schedulePet();
 }
 
 void Game::run() {
@@ -892,15 +1095,39 @@ void Game::run() {
 	backgroundMusic.play();
 
 	while (window.isOpen()) {
-		handleEvents();
+		bool hadInput = handleEvents();
+
+		// Read the clock once per frame; the pet is only touched when one of its events is due
+		std::time_t now = clock.now();
+		if (scheduler->advanceTo(now) > 0) {
+			actionLog.record(now, ACTION_UPDATE);
+		}
+		shop->advanceTo(now);
 
-		pet->update();
+		if (autosaver.maybeSave(*pet)) {
+			actionLog.flush();
+		}
+		// Unchanged stats are already in the committed slot
+		if (liveState.isOpen() && liveCommitClock.getElapsedTime().asSeconds() >= LIVE_COMMIT_INTERVAL &&
+			pet->getGeneration() != liveCommittedGeneration) {
+			liveState.commit();
+			liveCommittedGeneration = pet->getGeneration();
+			liveCommitClock.restart();
+		}
 
-		if (!window.hasFocus() && backgroundUpdateClock.getElapsedTime().asSeconds() >= BACKGROUND_UPDATE_INTERVAL) {
-			pet->savePetToFile(saveFilePath);
-			backgroundUpdateClock.restart();
+		if (inBackground) {
+			sf::sleep(sf::seconds(secondsUntilWork(BACKGROUND_MAX_SLEEP)));
+			continue;
 		}
 
-		updateUI();
+		// Input can change what is on screen without touching the pet (opening a menu, typing)
+		std::uint64_t sceneGeneration = getSceneGeneration();
+		if (hadInput || sceneGeneration != drawnSceneGeneration) {
+			drawnSceneGeneration = sceneGeneration;
+			updateUI();
+		}
+		else {
+			sf::sleep(sf::seconds(secondsUntilWork(IDLE_POLL_INTERVAL)));
+		}
 	}
 }
@@ -0,0 +1,75 @@
+#include <cmath>
+#include "quadBatch.h"
+
+QuadBatch::QuadBatch() : vertices(sf::Triangles), texture(nullptr) {}
+
+void QuadBatch::clear(const sf::Texture* batchTexture) {
+	vertices.clear();
+	texture = batchTexture;
+}
+
+void QuadBatch::addQuad(const sf::Transform& transform, const sf::FloatRect& rect, const sf::FloatRect& texRect, sf::Color color) {
+	const sf::Vector2f corners[4] = {
+		transform.transformPoint(rect.left, rect.top),
+		transform.transformPoint(rect.left + rect.width, rect.top),
+		transform.transformPoint(rect.left + rect.width, rect.top + rect.height),
+		transform.transformPoint(rect.left, rect.top + rect.height)
+	};
+	const sf::Vector2f texCorners[4] = {
+		{ texRect.left, texRect.top },
+		{ texRect.left + texRect.width, texRect.top },
+		{ texRect.left + texRect.width, texRect.top + texRect.height },
+		{ texRect.left, texRect.top + texRect.height }
+	};
+
+	// Two triangles: 0-1-2 and 0-2-3
+	for (int corner : { 0, 1, 2, 0, 2, 3 }) {
+		vertices.append(sf::Vertex(corners[corner], color, texCorners[corner]));
+	}
+}
+
+size_t QuadBatch::addSprite(const sf::Sprite& sprite) {
+	sf::IntRect source = sprite.getTextureRect();
+	sf::FloatRect texRect(static_cast<float>(source.left), static_cast<float>(source.top),
+		static_cast<float>(source.width), static_cast<float>(source.height));
+	// Negative sizes flip the sprite; the local quad keeps a positive size either way
+	sf::FloatRect rect(0, 0, std::abs(texRect.width), std::abs(texRect.height));
+
+	addQuad(sprite.getTransform(), rect, texRect, sprite.getColor());
+	return getQuadCount() - 1;
+}
+
+void QuadBatch::addRectangle(const sf::RectangleShape& shape) {
+	const sf::Transform& transform = shape.getTransform();
+	sf::Vector2f size = shape.getSize();
+	sf::FloatRect none;
+	addQuad(transform, sf::FloatRect(0, 0, size.x, size.y), none, shape.getFillColor());
+
+	// A positive outline grows outwards from the edge, a negative one inwards, as in sf::Shape
+	float thickness = shape.getOutlineThickness();
+	if (thickness == 0) return;
+	float edgeStart = thickness > 0 ? -thickness : 0;
+	float width = std::abs(thickness);
+	sf::Vector2f edgeEnd(size.x - edgeStart, size.y - edgeStart);
+	float sideHeight = edgeEnd.y - edgeStart - 2 * width;
+	sf::Color outline = shape.getOutlineColor();
+	addQuad(transform, sf::FloatRect(edgeStart, edgeStart, edgeEnd.x - edgeStart, width), none, outline);
+	addQuad(transform, sf::FloatRect(edgeStart, edgeEnd.y - width, edgeEnd.x - edgeStart, width), none, outline);
+	addQuad(transform, sf::FloatRect(edgeStart, edgeStart + width, width, sideHeight), none, outline);
+	addQuad(transform, sf::FloatRect(edgeEnd.x - width, edgeStart + width, width, sideHeight), none, outline);
+}
+
+void QuadBatch::setQuadColor(size_t quad, sf::Color color) {
+	for (size_t i = quad * VERTICES_PER_QUAD; i < (quad + 1) * VERTICES_PER_QUAD; i++) {
+		vertices[i].color = color;
+	}
+}
+
+void QuadBatch::draw(sf::RenderTarget& target) const {
+	if (vertices.getVertexCount() == 0) return;
+	target.draw(vertices, sf::RenderStates(texture));
+}
+
+size_t QuadBatch::getQuadCount() const {
+	return vertices.getVertexCount() / VERTICES_PER_QUAD;
+}
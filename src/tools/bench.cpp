@@ -0,0 +1,872 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <new>
+#include "autosaver.h"
+#include "coreLog.h"
+#include "fastForward.h"
+#include "itemCatalog.h"
+#include "petPopulation.h"
+#include "petScheduler.h"
+#include "petStore.h"
+#include "saveFormat.h"
+#include "shop.h"
+#include "uiSources.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Counts heap allocations, so the frame benchmark can check that idle frames make none
+std::atomic<size_t> allocationCount{ 0 };
+
+void* operator new(std::size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size ? size : 1)) return memory;
+	throw std::bad_alloc();
+}
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+double secondsSince(BenchClock::time_point start) {
+	return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+// Flushes a file that was written through a stream, as writePetSave does for its own
+bool syncFile(const std::string& filename) {
+#ifdef _WIN32
+	int fd = _open(filename.c_str(), _O_RDWR | _O_BINARY);
+	if (fd < 0) return false;
+	bool synced = _commit(fd) == 0;
+	_close(fd);
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	bool synced = ::fsync(fd) == 0;
+	::close(fd);
+#endif
+	return synced;
+}
+
+PetPopulation makeRandomPopulation(size_t count, unsigned int seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> stat(0, 100);
+	std::uniform_int_distribution<int> deadRoll(0, 9);
+
+	PetPopulation population;
+	population.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		population.addPet(stat(rng), stat(rng), stat(rng), stat(rng), stat(rng), deadRoll(rng) != 0);
+	}
+	return population;
+}
+
+bool samePopulation(const PetPopulation& a, const PetPopulation& b) {
+	for (size_t i = 0; i < a.size(); i++) {
+		if (a.getHunger(i) != b.getHunger(i) ||
+			a.getHappiness(i) != b.getHappiness(i) ||
+			a.getEnergy(i) != b.getEnergy(i) ||
+			a.getCleanliness(i) != b.getCleanliness(i) ||
+			a.getHealth(i) != b.getHealth(i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Ticks a random population one minute at a time with every kernel the CPU supports
+int benchPopulation(size_t petCount, int ticks) {
+	std::cout << "Population decay: " << petCount << " pets, " << ticks << " ticks" << std::endl;
+
+	PetPopulation reference = makeRandomPopulation(petCount, 42);
+	DecayKernel best = PetPopulation::bestKernel();
+	bool ok = true;
+
+	for (int k = DECAY_SCALAR; k <= best; k++) {
+		DecayKernel kernel = static_cast<DecayKernel>(k);
+		PetPopulation population = makeRandomPopulation(petCount, 42);
+
+		auto start = BenchClock::now();
+		for (int t = 0; t < ticks; t++) {
+			population.decay(1, kernel);
+		}
+		double seconds = secondsSince(start);
+
+		if (kernel == DECAY_SCALAR) {
+			reference = population;
+		}
+		bool matches = samePopulation(reference, population);
+		ok = ok && matches;
+
+		std::cout << "  " << PetPopulation::kernelName(kernel) << ": "
+			<< static_cast<double>(petCount) * ticks / seconds / 1e6 << " M pet-ticks/s"
+			<< (matches ? "" : " (MISMATCH vs scalar)") << std::endl;
+	}
+
+	return ok ? 0 : 1;
+}
+
+bool sameState(const PetState& x, const PetState& y) {
+	return x.hunger == y.hunger && x.happiness == y.happiness && x.energy == y.energy &&
+		x.cleanliness == y.cleanliness && x.health == y.health && x.age == y.age &&
+		x.isAlive == y.isAlive && x.lastUpdateTime == y.lastUpdateTime && x.lastAgeTime == y.lastAgeTime &&
+		x.birthTime == y.birthTime &&
+		x.criticalHungerStartTime == y.criticalHungerStartTime &&
+		x.criticalHealthStartTime == y.criticalHealthStartTime &&
+		x.isInCriticalHunger == y.isInCriticalHunger && x.isInCriticalHealth == y.isInCriticalHealth;
+}
+
+bool sameResult(const FastForwardResult& a, const FastForwardResult& b) {
+	return sameState(a.state, b.state) &&
+		a.hungerCriticalTime == b.hungerCriticalTime && a.healthCriticalTime == b.healthCriticalTime &&
+		a.deathTime == b.deathTime && a.deathCause == b.deathCause && a.daysAged == b.daysAged;
+}
+
+std::vector<PetState> makeRandomStates(size_t count, unsigned int seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> stat(0, 100);
+	std::uniform_int_distribution<int> coin(0, 1);
+	std::uniform_int_distribution<int> secondsAgo(0, 7200);
+
+	const std::time_t base = 1700000000;
+	std::vector<PetState> states(count);
+	for (PetState& s : states) {
+		s.hunger = stat(rng);
+		s.happiness = stat(rng);
+		s.energy = stat(rng);
+		s.cleanliness = stat(rng);
+		s.health = stat(rng);
+		s.age = stat(rng);
+		s.isAlive = true;
+		s.lastUpdateTime = base;
+		s.lastAgeTime = base - secondsAgo(rng) % 300;
+		s.birthTime = base - 86400;
+		s.isInCriticalHunger = coin(rng) != 0;
+		s.isInCriticalHealth = coin(rng) != 0;
+		s.criticalHungerStartTime = s.isInCriticalHunger ? base - secondsAgo(rng) : 0;
+		s.criticalHealthStartTime = s.isInCriticalHealth ? base - secondsAgo(rng) : 0;
+	}
+	return states;
+}
+
+// Checks the closed-form catch-up against minute-by-minute ticking, then times both
+int benchFastForward(size_t petCount, int awayDays) {
+	std::cout << "Fast-forward: " << petCount << " pets, up to " << awayDays << " days away" << std::endl;
+
+	std::vector<PetState> states = makeRandomStates(petCount, 7);
+	std::mt19937 rng(11);
+	std::uniform_int_distribution<long long> away(0, static_cast<long long>(awayDays) * 86400);
+	std::vector<std::time_t> targets(petCount);
+	for (size_t i = 0; i < petCount; i++) {
+		targets[i] = states[i].lastUpdateTime + static_cast<std::time_t>(away(rng));
+	}
+
+	size_t mismatches = 0;
+	auto start = BenchClock::now();
+	for (size_t i = 0; i < petCount; i++) {
+		if (!sameResult(fastForward(states[i], targets[i]), stepForward(states[i], targets[i]))) {
+			mismatches++;
+		}
+	}
+	double checkSeconds = secondsSince(start);
+
+	long long checksum = 0;
+	start = BenchClock::now();
+	for (size_t i = 0; i < petCount; i++) {
+		checksum += fastForward(states[i], targets[i]).state.age;
+	}
+	double fastSeconds = secondsSince(start);
+
+	std::cout << "  closed form: " << static_cast<double>(petCount) / fastSeconds / 1e6 << " M pets/s (checksum " << checksum << ")" << std::endl;
+	std::cout << "  checked against per-minute ticking in " << checkSeconds << " s, "
+		<< mismatches << " mismatches" << std::endl;
+	return mismatches == 0 ? 0 : 1;
+}
+
+std::vector<std::unique_ptr<Pet>> makeRandomPets(size_t count, std::time_t now, unsigned int seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> stat(0, 60);
+	std::uniform_int_distribution<int> offset(0, 299);
+
+	std::vector<std::unique_ptr<Pet>> pets;
+	pets.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		auto pet = std::make_unique<Pet>("Bench");
+		PetState s = pet->getState();
+		s.hunger = stat(rng);
+		s.happiness = 100 - stat(rng);
+		s.energy = 100 - stat(rng);
+		s.cleanliness = 100 - stat(rng);
+		s.lastUpdateTime = now - offset(rng) % 60;
+		s.lastAgeTime = now - offset(rng);
+		pet->setState(s);
+		pets.push_back(std::move(pet));
+	}
+	return pets;
+}
+
+// Polls every pet once per simulated second versus updating pets only when the
+// timer wheel says one of their events is due
+int benchScheduler(size_t petCount, int hours) {
+	std::cout << "Scheduler: " << petCount << " pets, " << hours << " simulated hours at one frame per second" << std::endl;
+
+	const std::time_t start = 1700000000;
+	const std::time_t end = start + static_cast<std::time_t>(hours) * 3600;
+
+	auto polled = makeRandomPets(petCount, start, 5);
+	auto begin = BenchClock::now();
+	for (std::time_t t = start; t <= end; t++) {
+		for (auto& pet : polled) {
+			pet->update(t);
+		}
+	}
+	double pollSeconds = secondsSince(begin);
+
+	auto scheduled = makeRandomPets(petCount, start, 5);
+	PetScheduler scheduler(start);
+	for (auto& pet : scheduled) {
+		scheduler.addPet(pet.get());
+	}
+	size_t updates = 0;
+	begin = BenchClock::now();
+	for (std::time_t t = start; t <= end; t++) {
+		updates += scheduler.advanceTo(t);
+	}
+	double scheduleSeconds = secondsSince(begin);
+
+	size_t mismatches = 0;
+	for (size_t i = 0; i < petCount; i++) {
+		polled[i]->update(end);
+		scheduled[i]->update(end);
+		if (polled[i]->getAge() != scheduled[i]->getAge() ||
+			polled[i]->getIsAlive() != scheduled[i]->getIsAlive() ||
+			polled[i]->getHunger() != scheduled[i]->getHunger() ||
+			polled[i]->getHealth() != scheduled[i]->getHealth()) {
+			mismatches++;
+		}
+	}
+
+	double frames = static_cast<double>(end - start + 1);
+	std::cout << "  polling:   " << frames * petCount << " pet updates in " << pollSeconds << " s" << std::endl;
+	std::cout << "  scheduler: " << updates << " pet updates in " << scheduleSeconds << " s ("
+		<< scheduler.getEventCount(PET_EVENT_DECAY) << " decay, "
+		<< scheduler.getEventCount(PET_EVENT_CRITICAL) << " critical, "
+		<< scheduler.getEventCount(PET_EVENT_DEATH) << " death, "
+		<< scheduler.getEventCount(PET_EVENT_AGING) << " aging)" << std::endl;
+	std::cout << "  " << mismatches << " pets differ between the two" << std::endl;
+	return mismatches == 0 ? 0 : 1;
+}
+
+long long populationChecksum(const PetPopulation& population) {
+	long long sum = 0;
+	for (size_t i = 0; i < population.size(); i++) {
+		sum = sum * 31 + population.getHunger(i) + population.getHealth(i) * 7 + population.getEnergy(i) * 13;
+	}
+	return sum;
+}
+
+// Sharded decay on 1, 2, 4, ... threads up to maxThreads, per tick and cache-blocked; results
+// must match the single-thread run. Per-tick decay streams every stat column through memory
+// once per tick, so it stops scaling once memory bandwidth is saturated.
+int benchScaling(size_t petCount, int ticks, size_t maxThreads) {
+	if (maxThreads == 0) {
+		maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+	std::cout << "Parallel decay scaling: " << petCount << " pets, " << ticks << " ticks, up to "
+		<< maxThreads << " threads" << std::endl;
+
+	std::vector<size_t> threadCounts;
+	for (size_t t = 1; t < maxThreads; t *= 2) {
+		threadCounts.push_back(t);
+	}
+	threadCounts.push_back(maxThreads);
+
+	double baseRate = 0.0;
+	double baseBlockedRate = 0.0;
+	long long baseChecksum = 0;
+	bool ok = true;
+	for (size_t threads : threadCounts) {
+		ThreadPool pool(threads);
+		PetPopulation population = makeRandomPopulation(petCount, 42);
+
+		auto start = BenchClock::now();
+		for (int t = 0; t < ticks; t++) {
+			population.decay(1, pool);
+		}
+		double rate = static_cast<double>(petCount) * ticks / secondsSince(start);
+		long long checksum = populationChecksum(population);
+
+		// Same work with every shard running all ticks while it is in cache
+		PetPopulation blocked = makeRandomPopulation(petCount, 42);
+		start = BenchClock::now();
+		blocked.decayTicks(ticks, 1, pool);
+		double blockedRate = static_cast<double>(petCount) * ticks / secondsSince(start);
+
+		if (threads == 1) {
+			baseRate = rate;
+			baseBlockedRate = blockedRate;
+			baseChecksum = checksum;
+		}
+		bool matches = checksum == baseChecksum && populationChecksum(blocked) == baseChecksum;
+		ok = ok && matches;
+
+		std::cout << "  " << threads << " threads: per-tick " << rate / 1e6 << " M pet-ticks/s (speedup "
+			<< rate / baseRate << "x), blocked " << blockedRate / 1e6 << " M pet-ticks/s (speedup "
+			<< blockedRate / baseBlockedRate << "x), " << pool.getStolenTaskCount() << " shards stolen"
+			<< (matches ? "" : " (MISMATCH vs 1 thread)") << std::endl;
+	}
+	return ok ? 0 : 1;
+}
+
+// Saves and reloads every pet in both the legacy text format and the binary format
+int benchSave(size_t petCount) {
+	std::cout << "Save files: " << petCount << " pets" << std::endl;
+
+	namespace fs = std::filesystem;
+	fs::path directory = fs::temp_directory_path() / "tamatama-bench-saves";
+	fs::create_directories(directory);
+
+	std::vector<PetState> states = makeRandomStates(petCount, 5);
+	FixedStepClock clock(states.empty() ? 0 : states[0].lastUpdateTime);
+	std::vector<std::unique_ptr<Pet>> pets;
+	pets.reserve(petCount);
+	for (size_t i = 0; i < petCount; i++) {
+		pets.push_back(std::make_unique<Pet>("Bench " + std::to_string(i), clock));
+		pets.back()->setState(states[i]);
+		// Settle the pet at the current time so the catch-up done on load is a no-op
+		pets.back()->update();
+	}
+
+	// Encoding and validating alone, without any file I/O
+	std::string buffer;
+	size_t encodedBytes = 0;
+	auto start = BenchClock::now();
+	for (size_t i = 0; i < petCount; i++) {
+		encodePetSave(pets[i]->snapshot(), buffer);
+		encodedBytes += buffer.size();
+	}
+	double encodeSeconds = secondsSince(start);
+	size_t viewed = 0;
+	start = BenchClock::now();
+	for (size_t i = 0; i < petCount; i++) {
+		if (viewPetSave(buffer.data(), buffer.size())) viewed++;
+	}
+	double viewSeconds = secondsSince(start);
+	std::cout << "  binary in memory: " << static_cast<double>(petCount) / encodeSeconds << " encodes/s, "
+		<< static_cast<double>(petCount) / viewSeconds << " validated views/s, "
+		<< (petCount > 0 ? encodedBytes / petCount : 0) << " bytes/pet" << std::endl;
+
+	// Both formats are timed as durable writes: writePetSave syncs the binary save itself,
+	// and the text save is synced after it is written. The binary save also renames and
+	// syncs the directory, which is the price of the atomic replace.
+	struct Format {
+		const char* label;
+		const char* extension;
+		bool (Pet::*save)(const std::string&) const;
+		bool syncAfterSave;
+	};
+	const Format formats[] = {
+		{ "text  ", ".txt", &Pet::savePetToTextFile, true },
+		{ "binary", ".save", &Pet::savePetToFile, false },
+	};
+
+	bool ok = viewed == petCount;
+	for (const Format& format : formats) {
+		std::vector<std::string> files(petCount);
+		for (size_t i = 0; i < petCount; i++) {
+			files[i] = (directory / ("pet" + std::to_string(i) + format.extension)).string();
+		}
+
+		start = BenchClock::now();
+		for (size_t i = 0; i < petCount; i++) {
+			ok = ((*pets[i]).*format.save)(files[i]) && ok;
+			if (format.syncAfterSave) ok = syncFile(files[i]) && ok;
+		}
+		double saveSeconds = secondsSince(start);
+
+		size_t mismatches = 0;
+		Pet loaded("", clock);
+		start = BenchClock::now();
+		for (size_t i = 0; i < petCount; i++) {
+			if (!loaded.loadPetFromFile(files[i]) || !sameState(loaded.getState(), pets[i]->getState()) ||
+				loaded.getName() != pets[i]->getName() ||
+				loaded.getInventory().size() != pets[i]->getInventory().size()) {
+				mismatches++;
+			}
+		}
+		double loadSeconds = secondsSince(start);
+
+		std::cout << "  " << format.label << ": " << static_cast<double>(petCount) / saveSeconds << " durable saves/s, "
+			<< static_cast<double>(petCount) / loadSeconds << " loads/s, "
+			<< (petCount > 0 ? fs::file_size(files[0]) : 0) << " bytes/pet, "
+			<< mismatches << " mismatches" << std::endl;
+		ok = ok && mismatches == 0;
+	}
+
+	fs::remove_all(directory);
+	return ok ? 0 : 1;
+}
+
+
+// Single-file pet store: inserts, lookups, in-place stat updates and reuse after deaths
+int benchStore(size_t petCount, size_t lookups) {
+	std::cout << "Pet store: " << petCount << " pets, " << lookups << " lookups" << std::endl;
+
+	namespace fs = std::filesystem;
+	fs::path storePath = fs::temp_directory_path() / "tamatama-bench.store";
+	fs::remove(storePath);
+
+	std::vector<PetState> states = makeRandomStates(petCount, 9);
+	FixedStepClock clock(states.empty() ? 0 : states[0].lastUpdateTime);
+	PetSnapshot snapshot = Pet("", clock).snapshot();
+	auto petName = [](size_t i) { return "pet-" + std::to_string(i); };
+	// Same length as petName, so a replacement fits the heap block its predecessor freed
+	auto nextName = [](size_t i) { return "new-" + std::to_string(i); };
+
+	PetStore store;
+	if (!store.open(storePath.string(), petCount)) return 1;
+
+	bool ok = true;
+	auto start = BenchClock::now();
+	for (size_t i = 0; i < petCount; i++) {
+		snapshot.name = petName(i);
+		snapshot.state = states[i];
+		ok = store.put(snapshot) && ok;
+	}
+	double insertSeconds = secondsSince(start);
+	std::uintmax_t fullSize = fs::file_size(storePath);
+
+	std::mt19937 rng(3);
+	std::uniform_int_distribution<size_t> pick(0, petCount - 1);
+	std::vector<size_t> order(lookups);
+	for (size_t& index : order) index = pick(rng);
+
+	size_t mismatches = 0;
+	PetSnapshot loaded;
+	start = BenchClock::now();
+	for (size_t index : order) {
+		if (!store.load(petName(index), loaded) || !sameState(loaded.state, states[index]) ||
+			loaded.inventory.size() != snapshot.inventory.size()) {
+			mismatches++;
+		}
+	}
+	double loadSeconds = secondsSince(start);
+
+	PetState state;
+	start = BenchClock::now();
+	for (size_t index : order) {
+		if (!store.loadState(petName(index), state)) mismatches++;
+		state.hunger = (state.hunger + 1) % 101;
+		states[index].hunger = state.hunger;
+		ok = store.updateState(petName(index), state) && ok;
+	}
+	double updateSeconds = secondsSince(start);
+
+	// Every tenth pet dies and a new one takes its place; the file must not grow
+	size_t replaced = 0;
+	for (size_t i = 0; i < petCount; i += 10) {
+		ok = store.remove(petName(i)) && ok;
+		snapshot.name = nextName(i);
+		snapshot.state = states[i];
+		ok = store.put(snapshot) && ok;
+		replaced++;
+	}
+	bool reused = fs::file_size(storePath) == fullSize;
+
+	store.close();
+	ok = store.open(storePath.string()) && ok;
+	for (size_t i = 0; i < petCount; i++) {
+		bool dead = i % 10 == 0;
+		if (!store.loadState(dead ? nextName(i) : petName(i), state) || !sameState(state, states[i]) ||
+			store.contains(petName(i)) == dead) {
+			mismatches++;
+		}
+	}
+	bool countOk = store.size() == petCount;
+	store.close();
+	fs::remove(storePath);
+
+	std::cout << "  insert: " << static_cast<double>(petCount) / insertSeconds << " pets/s, "
+		<< static_cast<double>(fullSize) / static_cast<double>(std::max<size_t>(petCount, 1)) << " bytes/pet" << std::endl;
+	std::cout << "  load:   " << static_cast<double>(lookups) / loadSeconds << " pets/s" << std::endl;
+	std::cout << "  update: " << static_cast<double>(lookups) / updateSeconds << " read+write/s (in place)" << std::endl;
+	std::cout << "  " << replaced << " deaths replaced, " << (reused ? "no file growth" : "FILE GREW")
+		<< ", " << mismatches << " mismatches" << std::endl;
+	return ok && reused && countOk && mismatches == 0 ? 0 : 1;
+}
+
+// The virtual item hierarchy that tagged items replaced (same effects and log lines), kept
+// here as the baseline
+class VirtualItem {
+protected:
+	std::string name;
+public:
+	explicit VirtualItem(const std::string& itemName) : name(itemName) {}
+	virtual ~VirtualItem() = default;
+	virtual void use(Pet& pet) const = 0;
+	virtual int effect() const = 0;
+};
+
+class VirtualFood : public VirtualItem {
+	int hungerReduction;
+public:
+	VirtualFood(const std::string& foodName, int hungerReduc) : VirtualItem(foodName), hungerReduction(hungerReduc) {}
+	void use(Pet& pet) const override {
+		pet.feed(hungerReduction);
+		coreLog() << "Fed " << name << " to pet. Hunger reduced by " << hungerReduction << std::endl;
+	}
+	int effect() const override { return hungerReduction; }
+};
+
+class VirtualMedicine : public VirtualItem {
+	int healthBoost;
+public:
+	VirtualMedicine(const std::string& medName, int healthB) : VirtualItem(medName), healthBoost(healthB) {}
+	void use(Pet& pet) const override {
+		pet.medicine(healthBoost);
+		coreLog() << "Used " << name << " on pet. Health increased by " << healthBoost << std::endl;
+	}
+	int effect() const override { return healthBoost; }
+};
+
+// Category filtering and use dispatch: dynamic_cast and virtual calls vs. the item type tag
+int benchItems(size_t itemCount, int rounds) {
+	std::cout << "Items: " << itemCount << " items, " << rounds << " rounds" << std::endl;
+
+	const ItemCatalog& catalog = ItemCatalog::get();
+	std::mt19937 rng(5);
+	std::uniform_int_distribution<int> pick(0, static_cast<int>(catalog.size()) - 1);
+
+	std::vector<ItemId> tagged(itemCount);
+	std::vector<std::unique_ptr<VirtualItem>> virtualItems;
+	virtualItems.reserve(itemCount);
+	for (ItemId& id : tagged) {
+		id = static_cast<ItemId>(pick(rng));
+		const Item& item = catalog.item(id);
+		if (item.isFood()) virtualItems.push_back(std::make_unique<VirtualFood>(item.getName(), item.getFoodEffect().hungerReduction));
+		else virtualItems.push_back(std::make_unique<VirtualMedicine>(item.getName(), item.getMedicineEffect().healthBoost));
+	}
+
+	size_t virtualFood = 0;
+	auto start = BenchClock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (const auto& item : virtualItems) {
+			if (dynamic_cast<const VirtualFood*>(item.get())) virtualFood++;
+		}
+	}
+	double virtualFilterSeconds = secondsSince(start);
+
+	size_t taggedFood = 0;
+	start = BenchClock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (ItemId id : tagged) {
+			if (catalog.item(id).isFood()) taggedFood++;
+		}
+	}
+	double taggedFilterSeconds = secondsSince(start);
+
+	// Dispatch alone: a virtual call against the switch on the tag, with no Pet work behind it
+	long long virtualEffects = 0;
+	start = BenchClock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (const auto& item : virtualItems) virtualEffects += item->effect();
+	}
+	double virtualDispatchSeconds = secondsSince(start);
+
+	long long taggedEffects = 0;
+	start = BenchClock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (ItemId id : tagged) {
+			const Item& item = catalog.item(id);
+			switch (item.getType()) {
+			case ITEM_FOOD: taggedEffects += item.getFoodEffect().hungerReduction; break;
+			case ITEM_MEDICINE: taggedEffects += item.getMedicineEffect().healthBoost; break;
+			default: break;
+			}
+		}
+	}
+	double taggedDispatchSeconds = secondsSince(start);
+
+	FixedStepClock clock(1700000000);
+	Pet virtualPet("", clock);
+	start = BenchClock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (const auto& item : virtualItems) item->use(virtualPet);
+	}
+	double virtualUseSeconds = secondsSince(start);
+
+	Pet taggedPet("", clock);
+	start = BenchClock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (ItemId id : tagged) catalog.item(id).use(&taggedPet);
+	}
+	double taggedUseSeconds = secondsSince(start);
+
+	double work = static_cast<double>(itemCount) * rounds / 1e6;
+	std::cout << "  filter dynamic_cast: " << work / virtualFilterSeconds << " M items/s" << std::endl;
+	std::cout << "  filter tag:          " << work / taggedFilterSeconds << " M items/s ("
+		<< virtualFilterSeconds / taggedFilterSeconds << "x)" << std::endl;
+	std::cout << "  dispatch virtual:    " << work / virtualDispatchSeconds << " M items/s" << std::endl;
+	std::cout << "  dispatch switch:     " << work / taggedDispatchSeconds << " M items/s ("
+		<< virtualDispatchSeconds / taggedDispatchSeconds << "x)" << std::endl;
+	// Pet::feed/medicine and the (disabled) log line dominate here, so expect about 1x
+	std::cout << "  use virtual:         " << work / virtualUseSeconds << " M items/s" << std::endl;
+	std::cout << "  use switch:          " << work / taggedUseSeconds << " M items/s ("
+		<< virtualUseSeconds / taggedUseSeconds << "x, bounded by the Pet update)" << std::endl;
+
+	bool ok = virtualFood == taggedFood && virtualEffects == taggedEffects &&
+		virtualPet.getState() == taggedPet.getState();
+	if (!ok) std::cerr << "Tagged items disagree with the virtual baseline" << std::endl;
+	return ok ? 0 : 1;
+}
+
+// Buying items one call at a time vs. one buyItems batch, plus a batch that must roll back
+int benchPurchase(size_t itemCount, int rounds) {
+	std::cout << "Purchase: " << itemCount << " items, " << rounds << " rounds" << std::endl;
+
+	// Shelves deep enough for the whole order list; stock limits are checked below
+	BalanceTable deepShelves = balance();
+	deepShelves.shopStockPerItem = static_cast<int>(std::min<size_t>(itemCount, INT_MAX));
+	ScopedBalance deepShelvesRules(deepShelves);
+	FixedStepClock clock(1700000000);
+	PetShop probe;
+	std::mt19937 rng(9);
+	std::uniform_int_distribution<size_t> pick(0, probe.getShopItems().size() - 1);
+	std::vector<PurchaseOrder> orders(itemCount);
+	int totalCost = 0;
+	for (PurchaseOrder& order : orders) {
+		order = { pick(rng), 1 };
+		totalCost += ItemCatalog::get().item(probe.getShopItems()[order.index]).getValue();
+	}
+
+	bool ok = true;
+	double singleSeconds = 0;
+	double batchSeconds = 0;
+	for (int r = 0; r < rounds; r++) {
+		PetShop singleShop;
+		Pet singlePet("", clock);
+		singleShop.addMoney(totalCost);
+		auto start = BenchClock::now();
+		for (const PurchaseOrder& order : orders) ok = singleShop.buyItem(order.index, &singlePet, clock.now()) && ok;
+		singleSeconds += secondsSince(start);
+
+		PetShop batchShop;
+		Pet batchPet("", clock);
+		batchShop.addMoney(totalCost);
+		start = BenchClock::now();
+		ok = batchShop.buyItems(orders, &batchPet, clock.now()) && ok;
+		batchSeconds += secondsSince(start);
+
+		ok = ok && singleShop.getMoney() == batchShop.getMoney() &&
+			singlePet.getInventory().getItemCount() == batchPet.getInventory().getItemCount();
+		for (const InventoryStack& stack : batchPet.getInventory().getStacks()) {
+			const Inventory& inventory = singlePet.getInventory();
+			const InventoryStack* other = inventory.find(inventory.findItem(stack.catalogId));
+			ok = ok && other && other->count == stack.count;
+		}
+	}
+
+	// One coin short, then one unit short: each batch must fail without spending anything,
+	// selling anything or adding items
+	PetShop shortShop;
+	Pet shortPet("", clock);
+	shortShop.addMoney(totalCost - shortShop.getMoney() - 1);
+	std::uint32_t itemsBefore = shortPet.getInventory().getItemCount();
+	bool rolledBack = !shortShop.buyItems(orders, &shortPet, clock.now()) && shortShop.getMoney() == totalCost - 1;
+	{
+		BalanceTable emptyShelves = balance();
+		emptyShelves.shopStockPerItem = 0;
+		ScopedBalance emptyShelvesRules(emptyShelves);
+		PetShop emptyShop;
+		emptyShop.addMoney(totalCost);
+		rolledBack = rolledBack && !emptyShop.buyItems(orders, &shortPet, clock.now()) &&
+			emptyShop.getMoney() == totalCost + balance().startingMoney && emptyShop.getStock(0) == 0 &&
+			shortPet.getInventory().getItemCount() == itemsBefore;
+	}
+
+	double work = static_cast<double>(itemCount) * rounds / 1e6;
+	std::cout << "  buyItem loop: " << work / singleSeconds << " M items/s" << std::endl;
+	std::cout << "  buyItems:     " << work / batchSeconds << " M items/s ("
+		<< singleSeconds / batchSeconds << "x)" << std::endl;
+	std::cout << "  unaffordable batch " << (rolledBack ? "rolled back" : "NOT ROLLED BACK") << std::endl;
+
+	if (!ok) std::cerr << "Batch purchase disagrees with single purchases" << std::endl;
+	return ok && rolledBack ? 0 : 1;
+}
+
+// The per-frame core work of Game::run() with the inventory and shop screens open, one
+// simulated second per frame, including the UiSources::plan decision Game::updateUI acts on.
+// A frame in which no pet event fires must neither allocate nor plan a rebuild. The SFML
+// side of updateUI (setString, shape and batch rebuilds) is not linked into this tool, so
+// it is only covered to the extent that it runs solely when the plan asks for it. Also
+// checks that widgets built for one pet or shop are never taken as current for a new one
+// that happens to have the same generation.
+int benchFrame(int frames) {
+	std::cout << "Frames: " << frames << " simulated seconds" << std::endl;
+
+	FixedStepClock clock(1700000000, 1);
+	Pet pet("", clock);
+	PetShop shop;
+	PetScheduler scheduler(clock.now());
+	size_t petId = scheduler.addPet(&pet);
+	Autosaver autosaver("bench.save", 1e9);
+	autosaver.markSaved(pet);
+	UiSources ui;
+
+	// Let the timer wheel and scheduler reach their working capacity first
+	const int warmupFrames = 2 * 3600;
+	size_t idleFrames = 0;
+	size_t idleAllocations = 0;
+	size_t idleRebuilds = 0;
+	auto start = BenchClock::now();
+	for (int frame = 0; frame < warmupFrames + frames; frame++) {
+		clock.advance();
+		size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+		size_t rebuildsBefore = ui.getRebuildCount();
+
+		std::time_t now = clock.now();
+		bool petUpdated = scheduler.advanceTo(now) > 0;
+		// Care for the pet now and then, as a player would; like any input, that is not idle
+		if (pet.getHunger() >= 50 || pet.getHealth() < 50) {
+			pet.feed(100);
+			pet.medicine(100);
+			scheduler.reschedule(petId);
+			petUpdated = true;
+		}
+		shop.advanceTo(now);
+		autosaver.maybeSave(pet);
+		// What refreshPetUI, updateInventoryUI and refreshShopStock record when they run
+		UiRefresh refresh = ui.plan(pet, shop, true, true);
+		if (refresh.pet) ui.markPet(pet);
+		if (refresh.inventory) ui.markInventory(pet);
+		if (refresh.shop) {
+			ui.markShop(shop);
+			for (size_t i = 0; i < SHOP_ITEMS.size(); i++) {
+				if (ui.shelfChanged(shop, i)) ui.markShelf(shop, i);
+			}
+		}
+
+		if (frame < warmupFrames || petUpdated) continue;
+		idleFrames++;
+		idleAllocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+		idleRebuilds += ui.getRebuildCount() - rebuildsBefore;
+	}
+	double seconds = secondsSince(start);
+	scheduler.removePet(petId);
+
+	// Fresh objects start at the same generations as each other
+	Pet firstPet("", clock);
+	Pet secondPet("", clock);
+	PetShop firstShop;
+	PetShop secondShop;
+	ui.markPet(firstPet);
+	ui.markInventory(firstPet);
+	ui.markShop(firstShop);
+	bool keyedOnIdentity = ui.petChanged(secondPet) && ui.inventoryChanged(secondPet) &&
+		ui.shopChanged(secondShop) && ui.shelfChanged(secondShop, 0) &&
+		!ui.inventoryChanged(firstPet) && !ui.shopChanged(firstShop);
+
+	std::cout << "  " << (warmupFrames + frames) / seconds / 1e6 << " M frames/s" << std::endl;
+	std::cout << "  idle frames: " << idleFrames << ", allocations: " << idleAllocations
+		<< ", widget rebuilds: " << idleRebuilds << std::endl;
+	std::cout << "  new pet and shop " << (keyedOnIdentity ? "rebuild their widgets" : "REUSE STALE WIDGETS") << std::endl;
+	std::cout << "  (core frame work and rebuild decisions only; SFML widget code is not run)" << std::endl;
+
+	bool ok = idleFrames > 0 && idleAllocations == 0 && idleRebuilds == 0 && keyedOnIdentity;
+	if (!ok) std::cerr << "Steady-state frames are not free" << std::endl;
+	return ok ? 0 : 1;
+}
+}
+
+// Usage: TamaTamaBench population [pets] [ticks]
+//        TamaTamaBench fastforward [pets] [days-away]
+//        TamaTamaBench scheduler [pets] [hours]
+//        TamaTamaBench scaling [pets] [ticks] [max-threads]
+//        TamaTamaBench save [pets]
+//        TamaTamaBench store [pets] [lookups]
+//        TamaTamaBench items [items] [rounds]
+//        TamaTamaBench purchase [items] [rounds]
+//        TamaTamaBench frame [frames]
+int main(int argc, char* argv[]) {
+	setCoreLogging(false);
+	std::string benchmark = argc > 1 ? argv[1] : "population";
+
+	if (benchmark == "population") {
+		size_t petCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+		int ticks = argc > 3 ? std::atoi(argv[3]) : 20;
+		return benchPopulation(petCount, ticks);
+	}
+	if (benchmark == "fastforward") {
+		size_t petCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+		int awayDays = argc > 3 ? std::atoi(argv[3]) : 14;
+		return benchFastForward(petCount, awayDays);
+	}
+	if (benchmark == "scheduler") {
+		size_t petCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+		int hours = argc > 3 ? std::atoi(argv[3]) : 2;
+		return benchScheduler(petCount, hours);
+	}
+	if (benchmark == "scaling") {
+		size_t petCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50000000;
+		int ticks = argc > 3 ? std::atoi(argv[3]) : 20;
+		size_t maxThreads = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 0;
+		return benchScaling(petCount, ticks, maxThreads);
+	}
+
+	if (benchmark == "save") {
+		size_t petCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+		return benchSave(petCount);
+	}
+
+	if (benchmark == "store") {
+		size_t petCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+		size_t lookups = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 100000;
+		return benchStore(petCount, lookups);
+	}
+
+	if (benchmark == "items") {
+		size_t itemCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+		int rounds = argc > 3 ? std::atoi(argv[3]) : 200;
+		return benchItems(itemCount, rounds);
+	}
+
+	if (benchmark == "purchase") {
+		size_t itemCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+		int rounds = argc > 3 ? std::atoi(argv[3]) : 100;
+		return benchPurchase(itemCount, rounds);
+	}
+
+	if (benchmark == "frame") {
+		int frames = argc > 2 ? std::atoi(argv[2]) : 86400;
+		return benchFrame(frames);
+	}
+
+	std::cerr << "Unknown benchmark: " << benchmark << std::endl;
+	std::cerr << "Usage: " << argv[0] << " population [pets] [ticks]" << std::endl;
+	std::cerr << "       " << argv[0] << " fastforward [pets] [days-away]" << std::endl;
+	std::cerr << "       " << argv[0] << " scheduler [pets] [hours]" << std::endl;
+	std::cerr << "       " << argv[0] << " scaling [pets] [ticks] [max-threads]" << std::endl;
+	std::cerr << "       " << argv[0] << " save [pets]" << std::endl;
+	std::cerr << "       " << argv[0] << " store [pets] [lookups]" << std::endl;
+	std::cerr << "       " << argv[0] << " items [items] [rounds]" << std::endl;
+	std::cerr << "       " << argv[0] << " purchase [items] [rounds]" << std::endl;
+	std::cerr << "       " << argv[0] << " frame [frames]" << std::endl;
+	return 1;
+}
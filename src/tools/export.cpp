@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "columnar.h"
+#include "coreLog.h"
+#include "petStore.h"
+#include "threadPool.h"
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+double secondsSince(SteadyClock::time_point start) {
+	return std::chrono::duration<double>(SteadyClock::now() - start).count();
+}
+
+void printUsage(const char* program) {
+	std::cerr << "Usage: " << program << " write <out.col> [--store FILE | --pets N] [--seed S] [--row-group ROWS] [--plain]" << std::endl;
+	std::cerr << "       " << program << " scan <file.col> [--threads T]" << std::endl;
+}
+
+// Synthetic population: pets born one after another over a year, 10% of them dead
+PetState randomPet(std::mt19937_64& rng, std::time_t birthTime) {
+	std::uniform_int_distribution<int> stat(0, 100);
+	std::uniform_int_distribution<int> ageDays(0, 365);
+	std::uniform_int_distribution<int> roll(0, 99);
+	std::uniform_int_distribution<int> seconds(0, 3599);
+
+	PetState s;
+	s.hunger = stat(rng);
+	s.happiness = stat(rng);
+	s.energy = stat(rng);
+	s.cleanliness = stat(rng);
+	s.health = stat(rng);
+	s.age = ageDays(rng);
+	s.isAlive = roll(rng) >= 10;
+	s.birthTime = birthTime;
+	s.lastAgeTime = birthTime + static_cast<std::time_t>(s.age) * balance().ageIntervalMinutes * 60;
+	s.lastUpdateTime = s.lastAgeTime + seconds(rng) / 60 * 60;
+	s.isInCriticalHunger = s.hunger >= balance().criticalHunger;
+	s.isInCriticalHealth = s.health <= balance().criticalHealth;
+	s.criticalHungerStartTime = s.isInCriticalHunger ? s.lastUpdateTime - seconds(rng) : 0;
+	s.criticalHealthStartTime = s.isInCriticalHealth ? s.lastUpdateTime - seconds(rng) : 0;
+	return s;
+}
+
+int writeExport(const std::string& outFile, const std::string& storeFile, size_t petCount,
+	std::uint64_t seed, size_t rowGroup, bool packing) {
+	ColumnarWriter writer;
+	if (!writer.open(outFile, rowGroup, packing)) return 1;
+
+	auto start = SteadyClock::now();
+	bool ok = true;
+	if (!storeFile.empty()) {
+		PetStore store;
+		if (!store.open(storeFile)) return 1;
+		PetState state;
+		for (const std::string& name : store.names()) {
+			if (store.loadState(name, state)) ok = writer.append(state) && ok;
+		}
+	}
+	else {
+		std::mt19937_64 rng(seed);
+		std::uniform_int_distribution<int> gap(0, 120);
+		std::time_t birthTime = 1700000000;
+		for (size_t i = 0; i < petCount && ok; i++) {
+			birthTime += gap(rng);
+			ok = writer.append(randomPet(rng, birthTime));
+		}
+	}
+	std::uint64_t rows = writer.getRowCount();
+	ok = writer.close() && ok;
+	double seconds = secondsSince(start);
+
+	std::cout << "Wrote " << rows << " rows to " << outFile << " in " << seconds << " s ("
+		<< static_cast<double>(rows) / seconds / 1e6 << " M rows/s)" << std::endl;
+	return ok ? 0 : 1;
+}
+
+struct ScanTotals {
+	std::uint64_t rows = 0;
+	std::uint64_t alive = 0;
+	std::uint64_t starved = 0;
+	std::uint64_t illness = 0;
+	std::int64_t statSums[5] = {};
+	std::int64_t ageSum = 0;
+	std::int64_t maxAge = 0;
+};
+
+int scanExport(const std::string& inFile, size_t threadCount) {
+	ColumnarReader reader;
+	if (!reader.open(inFile)) return 1;
+
+	auto start = SteadyClock::now();
+	ThreadPool pool(threadCount);
+	std::vector<ScanTotals> partials(reader.getRowGroupCount());
+
+	pool.parallelFor(reader.getRowGroupCount(), [&](size_t group) {
+		size_t rows = reader.getRowGroupSize(group);
+		std::vector<std::int64_t> columns[COLUMN_IN_CRITICAL_HEALTH + 1];
+		for (int c = COLUMN_HUNGER; c <= COLUMN_IN_CRITICAL_HEALTH; c++) {
+			columns[c].resize(rows);
+			reader.column(group, static_cast<PetColumn>(c)).decode(columns[c].data());
+		}
+
+		ScanTotals& totals = partials[group];
+		totals.rows = rows;
+		for (size_t i = 0; i < rows; i++) {
+			std::int64_t age = columns[COLUMN_AGE][i];
+			totals.ageSum += age;
+			totals.maxAge = std::max(totals.maxAge, age);
+			if (columns[COLUMN_IS_ALIVE][i]) {
+				totals.alive++;
+				for (int c = COLUMN_HUNGER; c <= COLUMN_HEALTH; c++) totals.statSums[c] += columns[c][i];
+			}
+			else if (columns[COLUMN_IN_CRITICAL_HUNGER][i]) {
+				totals.starved++;
+			}
+			else if (columns[COLUMN_IN_CRITICAL_HEALTH][i]) {
+				totals.illness++;
+			}
+		}
+	});
+
+	ScanTotals totals;
+	for (const ScanTotals& part : partials) {
+		totals.rows += part.rows;
+		totals.alive += part.alive;
+		totals.starved += part.starved;
+		totals.illness += part.illness;
+		for (int c = 0; c < 5; c++) totals.statSums[c] += part.statSums[c];
+		totals.ageSum += part.ageSum;
+		totals.maxAge = std::max(totals.maxAge, part.maxAge);
+	}
+	double seconds = secondsSince(start);
+
+	std::cout << "Scanned " << totals.rows << " rows in " << reader.getRowGroupCount() << " row groups on "
+		<< pool.getThreadCount() << " threads: " << seconds << " s ("
+		<< static_cast<double>(totals.rows) / seconds / 1e6 << " M rows/s)" << std::endl;
+	if (reader.getRowGroupCount() > 0) {
+		std::cout << "Encodings:";
+		for (int c = 0; c < COLUMN_COUNT; c++) {
+			ColumnView view = reader.column(0, static_cast<PetColumn>(c));
+			const char* encoding = view.getEncoding() == ENCODING_PLAIN ? "plain"
+				: view.getEncoding() == ENCODING_BITPACK ? "bitpack" : "delta";
+			std::cout << " " << columnName(static_cast<PetColumn>(c)) << "=" << encoding << "/" << view.getBitWidth();
+		}
+		std::cout << std::endl;
+	}
+
+	std::uint64_t dead = totals.rows - totals.alive;
+	std::cout << "Alive: " << totals.alive << ", dead: " << dead << " (starvation " << totals.starved
+		<< ", illness " << totals.illness << ", other " << dead - totals.starved - totals.illness << ")" << std::endl;
+	if (totals.rows > 0) {
+		std::cout << "Age: mean " << static_cast<double>(totals.ageSum) / static_cast<double>(totals.rows)
+			<< " days, max " << totals.maxAge << " days" << std::endl;
+	}
+	if (totals.alive > 0) {
+		std::cout << "Living pet averages:";
+		for (int c = COLUMN_HUNGER; c <= COLUMN_HEALTH; c++) {
+			std::cout << " " << columnName(static_cast<PetColumn>(c)) << " "
+				<< static_cast<double>(totals.statSums[c]) / static_cast<double>(totals.alive);
+		}
+		std::cout << std::endl;
+	}
+	return 0;
+}
+
+}
+
+// Streams a pet population into a columnar snapshot, or scans one back for summary statistics
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	std::string mode = argv[1];
+	std::string file = argv[2];
+	std::string storeFile;
+	size_t petCount = 1000000;
+	std::uint64_t seed = 1;
+	size_t rowGroup = 1 << 16;
+	size_t threadCount = 0;
+	bool packing = true;
+
+	for (int i = 3; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--store" && i + 1 < argc) storeFile = argv[++i];
+		else if (arg == "--pets" && i + 1 < argc) petCount = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--seed" && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--row-group" && i + 1 < argc) rowGroup = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--threads" && i + 1 < argc) threadCount = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--plain") packing = false;
+		else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	setCoreLogging(false);
+	if (mode == "write") return writeExport(file, storeFile, petCount, seed, rowGroup, packing);
+	if (mode == "scan") return scanExport(file, threadCount);
+	printUsage(argv[0]);
+	return 1;
+}
@@ -0,0 +1,113 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "balance.h"
+#include "clock.h"
+#include "pet.h"
+
+namespace {
+
+void printStatus(const Pet& pet) {
+	std::cout << pet.getName() << " - Age: " << pet.getAge() << " days, Mood: " << pet.getMood() << std::endl;
+	std::cout << "Hunger: " << pet.getHunger()
+		<< " Happiness: " << pet.getHappiness()
+		<< " Energy: " << pet.getEnergy()
+		<< " Cleanliness: " << pet.getCleanliness()
+		<< " Health: " << pet.getHealth() << std::endl;
+	std::cout << "Inventory: " << pet.getInventory().getItemCount() << " items" << std::endl;
+}
+
+void printUsage(const char* program) {
+	std::cerr << "Usage: " << program << " <save-file> [pet-name] [--run SECONDS] [--step SECONDS | --speed FACTOR] [--no-save] [--balance FILE]" << std::endl;
+	std::cerr << "  --run    simulate this many seconds of pet time (default: a single update)" << std::endl;
+	std::cerr << "  --step   advance a fixed-step clock by this much per update, as fast as possible (default 60)" << std::endl;
+	std::cerr << "  --speed  run against real time compressed by FACTOR instead" << std::endl;
+	std::cerr << "  --balance  override game rules from a key=value file (see include/balance.def)" << std::endl;
+}
+
+}
+
+// Loads (or creates) a pet, brings it up to date and saves it back, without opening a window.
+// With --run the pet is simulated on a fixed-step or accelerated clock, e.g. a one-week life:
+//   TamaTamaHeadless Saves/pet.save --run 604800
+int main(int argc, char* argv[]) {
+	std::string saveFilePath;
+	std::string petName = "Tama kun";
+	long long runSeconds = 0;
+	long long stepSeconds = 60;
+	double speed = 0.0;
+	bool shouldSave = true;
+	std::string balanceFile;
+
+	int positional = 0;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--run" && i + 1 < argc) runSeconds = std::atoll(argv[++i]);
+		else if (arg == "--step" && i + 1 < argc) stepSeconds = std::atoll(argv[++i]);
+		else if (arg == "--speed" && i + 1 < argc) speed = std::atof(argv[++i]);
+		else if (arg == "--no-save") shouldSave = false;
+		else if (arg == "--balance" && i + 1 < argc) balanceFile = argv[++i];
+		else if (positional == 0) { saveFilePath = arg; positional++; }
+		else if (positional == 1) { petName = arg; positional++; }
+		else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+	if (saveFilePath.empty() || stepSeconds <= 0) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	if (!balanceFile.empty() && !loadBalanceOverride(balanceFile)) {
+		return 1;
+	}
+
+	std::unique_ptr<Clock> simClock;
+	FixedStepClock* stepClock = nullptr;
+	if (speed > 0.0) {
+		simClock = std::make_unique<AcceleratedClock>(speed);
+	}
+	else {
+		auto fixed = std::make_unique<FixedStepClock>(std::time(nullptr), stepSeconds);
+		stepClock = fixed.get();
+		simClock = std::move(fixed);
+	}
+
+	Pet pet(petName, *simClock);
+	if (!pet.loadPetFromFile(saveFilePath)) {
+		std::cout << "Starting a new pet named " << petName << std::endl;
+	}
+
+	auto realStart = std::chrono::steady_clock::now();
+	const std::time_t endTime = simClock->now() + runSeconds;
+	long long updates = 0;
+
+	do {
+		pet.update(simClock->now());
+		updates++;
+
+		if (simClock->now() >= endTime || !pet.getIsAlive()) break;
+
+		if (stepClock) {
+			stepClock->advance();
+		}
+		else {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	} while (true);
+
+	double realSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - realStart).count();
+	if (runSeconds > 0) {
+		std::cout << "Simulated " << updates << " updates in " << realSeconds * 1000.0 << " ms" << std::endl;
+	}
+
+	printStatus(pet);
+
+	if (shouldSave && !pet.savePetToFile(saveFilePath)) {
+		return 1;
+	}
+	return 0;
+}
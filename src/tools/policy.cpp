@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "balance.h"
+#include "carePolicy.h"
+#include "coreLog.h"
+#include "fastForward.h"
+#include "threadPool.h"
+
+namespace {
+
+// SplitMix64, so neighbouring simulation indices get unrelated seeds
+std::uint64_t mixSeed(std::uint64_t x) {
+	x += 0x9E3779B97F4A7C15ull;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+	return x ^ (x >> 31);
+}
+
+void printUsage(const char* program) {
+	std::cerr << "Usage: " << program << " [policy-file] [--pets N] [--seed S] [--threads T] [--balance FILE]" << std::endl;
+}
+
+}
+
+// Monte-Carlo evaluation of a care policy: many independent pets raised from birth in parallel.
+// Each simulation has its own seeded RNG, so results are reproducible for any thread count.
+int main(int argc, char* argv[]) {
+	std::string policyFile;
+	size_t petCount = 10000;
+	std::uint64_t seed = 1;
+	size_t threadCount = 0;
+	std::string balanceFile;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--pets" && i + 1 < argc) petCount = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--seed" && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--threads" && i + 1 < argc) threadCount = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--balance" && i + 1 < argc) balanceFile = argv[++i];
+		else if (policyFile.empty() && arg.rfind("--", 0) != 0) policyFile = arg;
+		else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (!balanceFile.empty() && !loadBalanceOverride(balanceFile)) {
+		return 1;
+	}
+
+	CarePolicy policy;
+	if (!policyFile.empty() && !loadCarePolicy(policyFile, policy)) {
+		return 1;
+	}
+
+	setCoreLogging(false);
+	ThreadPool pool(threadCount);
+	std::vector<CareOutcome> outcomes(petCount);
+
+	auto start = std::chrono::steady_clock::now();
+	pool.parallelFor(petCount, [&](size_t i) {
+		outcomes[i] = simulateCare(policy, mixSeed(seed * 0x100000001B3ull + i));
+	});
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	size_t survived = 0;
+	size_t starved = 0;
+	size_t sick = 0;
+	double totalDays = 0.0;
+	double totalCoins = 0.0;
+	for (const CareOutcome& outcome : outcomes) {
+		survived += outcome.survived ? 1 : 0;
+		starved += outcome.deathCause == DEATH_STARVATION ? 1 : 0;
+		sick += outcome.deathCause == DEATH_ILLNESS ? 1 : 0;
+		totalDays += outcome.age;
+		totalCoins += outcome.coinsSpent;
+	}
+
+	double pets = static_cast<double>(petCount > 0 ? petCount : 1);
+	std::cout << "Pets simulated:  " << petCount << " on " << pool.getThreadCount() << " threads" << std::endl;
+	std::cout << "Survival rate:   " << 100.0 * survived / pets << "% (to " << policy.maxDays << " days)" << std::endl;
+	std::cout << "Deaths:          " << starved << " starvation, " << sick << " illness" << std::endl;
+	std::cout << "Mean lifespan:   " << totalDays / pets << " days" << std::endl;
+	std::cout << "Mean coin spend: " << totalCoins / pets << std::endl;
+	std::cout << "Throughput:      " << totalDays / seconds / 1e6 << " M pet-days/s" << std::endl;
+	return 0;
+}